@@ -6,15 +6,24 @@
 #include <utility>
 #include <thread>
 #include <future>
+#include <mutex>
 #include <ctime>
+#include "cj/data/data_matrix_view.hh"
+#include "cj/data/mapped_dataset.hh"
 #include "cj/logics/fuzzy_classifier.hh"
+#include "cj/logics/multi_logic.hh"
+#include "cj/logics/prepared_dataset.hh"
+#include "cj/logics/cross_validation.hh"
 #include "cj/utils/cl_reader.hh"
+#include "cj/utils/parallel.hh"
 #include "cj/math/statistics.hh"
 
+// 'lut_bits': the fuzzy sets are sampled in lookup tables of 2^lut_bits entries (0: exact fuzzy sets).
 template<typename Truth>
-auto make_interpretation(size_t nsets, cj::data_matrix<double, uint32_t> const& dm)
+auto make_interpretation(size_t nsets, size_t lut_bits, cj::data_matrix_view<double, uint32_t> const& dm)
                          -> typename cj::fuzzy_classifier<Truth, double>::interpretation_ptr {
   auto i = cj::fuzzy_classifier<Truth, double>::make_interpretation({"Non-interaction", "Interaction"});
+  i->use_lookup_tables(lut_bits); // Data are normalized to [0, 1].
   i->add_triangular_partition(dm.input_name(0), 2, 0.0, 1.0);
   for (auto h = 1u; h < dm.input_names().size(); ++h) {
     i->add_triangular_partition(dm.input_name(h), nsets, 0.0, 1.0);
@@ -23,13 +32,25 @@ auto make_interpretation(size_t nsets, cj::data_matrix<double, uint32_t> const&
 }
 
 template<typename Truth>
-auto trial(size_t const seed, size_t const nsets, size_t const pop_size, size_t const t_max, double const alpha, cj::data_matrix<double, uint32_t> const& dm)
+using prepared = cj::prepared_dataset<cj::fuzzy_classifier<Truth, double, uint32_t>>;
+
+// Settings of the island model (a single population if islands <= 1).
+struct island_settings {
+  size_t islands;
+  size_t interval;
+  size_t migrants;
+  cj::migration_topology topology;
+};
+
+// Evolves a classifier using the interpretation 'i' on the fuzzified training rows.
+template<typename Truth>
+auto trial(size_t const seed, size_t const pop_size, size_t const t_max, double const alpha, size_t const evolve_threads, island_settings const& is,
+           typename cj::fuzzy_classifier<Truth, double, uint32_t>::interpretation_ptr const& i,
+           typename cj::fuzzy_classifier<Truth, double, uint32_t>::membership_tensor_type const& training)
           -> cj::fuzzy_classifier<Truth, double, uint32_t> {
   using classifier = cj::fuzzy_classifier<Truth, double, uint32_t>;
   using rule_type = typename classifier::rule_type;
 
-  auto rng = std::mt19937_64(seed);
-  auto i = make_interpretation<Truth>(nsets, dm);
   auto const rule0 = rule_type{{{0, 0}}, 0};
   auto const rule1 = rule_type{{{0, 1}}, 1};
   auto const initial_rule = classifier(i, {rule0, rule1});
@@ -74,25 +95,36 @@ auto trial(size_t const seed, size_t const nsets, size_t const pop_size, size_t
     }
   };
 
-  auto const fitness = [alpha](classifier const& c, cj::data_matrix<double, uint32_t> const& d) {
-    return c.evaluate_all(d).tss(1) - alpha * c.complexity();
+  auto const fitness = [alpha](classifier const& c, typename classifier::membership_tensor_type const& mt) {
+    return c.evaluate_all(mt).tss(1) - alpha * c.complexity();
   };
 
   auto const stop = [](double fit) { return fit >= 1.0; };
 
-  return classifier::evolve(initial_rule, mutate, fitness, stop, dm, pop_size, pop_size / 4, t_max, seed);
+  if (is.islands > 1) {
+    return classifier::evolve_islands(initial_rule, mutate, fitness, stop, training, is.islands, is.interval,
+                                      std::min(is.migrants, pop_size / 4), is.topology, pop_size, pop_size / 4,
+                                      t_max, seed, 100, 0.02, 10000);
+  }
+  return classifier::evolve(initial_rule, mutate, fitness, stop, training, pop_size, pop_size / 4, t_max, seed,
+                            100, 0.02, 10000, evolve_threads);
+}
+
+// 'training' is shared by concurrent trials.
+template<typename Truth>
+auto trial(size_t const seed, size_t const pop_size, size_t const t_max, double const alpha, size_t const evolve_threads, island_settings const& is,
+           typename prepared<Truth>::const_ptr const& training)
+          -> cj::fuzzy_classifier<Truth, double, uint32_t> {
+  return trial<Truth>(seed, pop_size, t_max, alpha, evolve_threads, is, training->interpretation(), training->memberships());
 }
 
 template<typename Truth>
 auto parallel_trials(cj::string const& tnorm, size_t const trials, size_t const threads,
-                     size_t const seed, size_t const nsets, size_t const pop_size,
-                     size_t const t_max, double alpha, cj::data_matrix<double, uint32_t> const& dm,
-                     cj::data_matrix<double, uint32_t> const& testing,
+                     size_t const seed, size_t const nsets, size_t const lut_bits, size_t const pop_size,
+                     size_t const t_max, double alpha, size_t const evolve_threads,
+                     island_settings const& is, cj::data_matrix_view<double, uint32_t> const& dm,
+                     cj::data_matrix_view<double, uint32_t> const& testing,
                      char const* filename_prefix) -> void {
-  using classifier = cj::fuzzy_classifier<Truth, double, uint32_t>;
-  auto futures = cj::vector<std::future<classifier>>{};
-  futures.reserve(trials);
-
   auto rng = std::mt19937_64(seed);
   auto seed_gen = std::uniform_int_distribution<size_t>{};
 
@@ -102,39 +134,104 @@ auto parallel_trials(cj::string const& tnorm, size_t const trials, size_t const
     seeds.push_back(seed_gen(rng));
   }
 
-  for (auto t = 0u; t < trials; ++t) {
-    futures.push_back(std::async([&](size_t const s) {
-      return trial<Truth>(s, nsets, pop_size, t_max, alpha, dm);
-    }, seeds[t]));
-  }
+  // The data are fuzzified once, and shared by all trials:
+  auto const training = prepared<Truth>::make(dm, make_interpretation<Truth>(nsets, lut_bits, dm));
+  auto const test = prepared<Truth>::make(testing, training->interpretation());
+  auto const initial_c = training->classifier({{{{0, 0}}, 0}, {{{0, 1}}, 1}});
+  auto const initial_results = cj::evaluate_all_logics(initial_c, test->memberships());
+  auto const own = size_t(cj::fuzzy_logic_of<Truth>::value);
 
-  auto bests = cj::vector<classifier>{};
-  bests.reserve(trials);
-  for (auto& f : futures) {
-    bests.push_back(f.get());
-  }
+  auto const filename = cj::string{filename_prefix} + cj::string{"-"}
+                        + boost::lexical_cast<cj::string>(seed) + cj::string{".txt"};
+
+  auto out = std::ofstream(filename);
+
+  out
+    << "Seed: " << seed << '\n'
+    << "Tnorm: " << tnorm << '\n'
+    << "Trials: " << trials << '\n'
+    << "Sets / input variables: " << nsets << '\n'
+    << "Lookup table bits: " << lut_bits << '\n'
+    << "Population size: " << pop_size << '\n'
+    << "T(max): " << t_max << '\n'
+    << "Alpha: " << alpha << '\n'
+    << '\n' << std::flush;
 
-  // Collect info on best knowedge bases:
-  auto tsses = cj::vector<double>{};
-  auto complexities = cj::vector<size_t>{};
-  auto nrules = cj::vector<size_t>{};
-  tsses.reserve(trials);
-  complexities.reserve(trials);
-  nrules.reserve(trials);
-  for (auto const& b : bests) {
-    tsses.push_back(b.evaluate_all(testing).tss(1));
-    complexities.push_back(b.complexity());
-    nrules.push_back(b.size());
+  // Info on the best knowledge bases, evaluated on the testing set under every logic:
+  std::array<cj::vector<double>, cj::num_fuzzy_logics> tsses;
+  for (auto& ts : tsses) {
+    ts.resize(trials);
   }
-  auto const evolved_tss = cj::fast_mean(tsses.begin(), tsses.end());
+  auto complexities = cj::vector<size_t>(trials);
+  auto nrules = cj::vector<size_t>(trials);
+
+  // Each trial writes its line as soon as it is done. The pool runs at most 'threads' threads in
+  // total, counting the threads of each evolution:
+  auto out_mutex = std::mutex{};
+  {
+    auto pool = cj::task_pool{threads / std::max(evolve_threads, size_t{1})};
+    for (auto t = 0u; t < trials; ++t) {
+      pool.submit([&, t] {
+        auto const b = trial<Truth>(seeds[t], pop_size, t_max, alpha, evolve_threads, is, training);
+        auto const results = cj::evaluate_all_logics(b, test->memberships());
+        for (auto l = 0u; l < cj::num_fuzzy_logics; ++l) {
+          tsses[l][t] = results[l].tss(1);
+        }
+        complexities[t] = b.complexity();
+        nrules[t] = b.size();
+
+        auto lock = std::lock_guard<std::mutex>{out_mutex};
+        out
+          << "Trial " << t << " (seed " << seeds[t] << "): Tss = " << tsses[own][t]
+          << ", complexity = " << complexities[t] << ", rules = " << nrules[t] << '\n' << std::flush;
+      });
+    }
+  } // Waits for all trials.
+
   auto const mean_complexity = cj::fast_mean(complexities.begin(), complexities.end());
   auto const mean_nrules = cj::fast_mean(nrules.begin(), nrules.end());
+  auto const initial_tss = initial_results[own].tss(1);
+  auto const evolved_tss = cj::fast_mean(tsses[own].begin(), tsses[own].end());
+
+  out
+    << '\n'
+    << "Mean complexity: " << mean_complexity << '\n'
+    << "Mean number of rules: " << mean_nrules << '\n'
+    << '\n'
+    << "Tss(initial): " << initial_tss << '\n'
+    << "Tss(evolved): " << evolved_tss << '\n'
+    << "Improvement: " << (evolved_tss - initial_tss) << '\n'
+    << '\n'
+    << "Rules evaluated under each logic:\n";
+  for (auto l = 0u; l < cj::num_fuzzy_logics; ++l) {
+    auto const name = cj::fuzzy_logic_name(cj::fuzzy_logic(l));
+    out
+      << "Tss(initial, " << name << "): " << initial_results[l].tss(1) << '\n'
+      << "Tss(evolved, " << name << "): " << cj::fast_mean(tsses[l].begin(), tsses[l].end()) << '\n';
+  }
 
-  auto i = make_interpretation<Truth>(nsets, dm);
-  auto const initial_c = classifier(i, {{{{0, 0}}, 0}, {{{0, 1}}, 1}});
-  auto const initial_tss = initial_c.evaluate_all(testing).tss(1);
+  out.close();
+}
+
+// Stratified k-fold cross-validation of the evolution on all the data, repeated 'repeats' times.
+// The folds are evolved in parallel, and the TSS of each fold is written to
+// '<filename_prefix>-<seed>.txt' along with their mean.
+template<typename Truth>
+auto cross_validation(cj::string const& tnorm, size_t const k, size_t const repeats, size_t const threads,
+                      size_t const seed, size_t const nsets, size_t const lut_bits, size_t const pop_size,
+                      size_t const t_max, double alpha, size_t const evolve_threads,
+                      island_settings const& is, cj::data_matrix_view<double, uint32_t> const& dm,
+                      char const* filename_prefix) -> void {
+  using membership_tensor_type = typename cj::fuzzy_classifier<Truth, double, uint32_t>::membership_tensor_type;
+
+  auto const ds = prepared<Truth>::make(dm, make_interpretation<Truth>(nsets, lut_bits, dm));
+  auto const folds = cj::stratified_kfold(ds->memberships().outputs(), k, repeats, seed);
+  auto const train = [&](membership_tensor_type const& training, cj::cv_fold const& fold) {
+    auto const s = cj::derive_seed(seed, fold.repeat, fold.fold);
+    return trial<Truth>(s, pop_size, t_max, alpha, evolve_threads, is, ds->interpretation(), training);
+  };
+  auto const results = cj::cross_validate(*ds, folds, train, threads / std::max(evolve_threads, size_t{1}));
 
-  // Print results to file:
   auto const filename = cj::string{filename_prefix} + cj::string{"-"}
                         + boost::lexical_cast<cj::string>(seed) + cj::string{".txt"};
 
@@ -143,64 +240,233 @@ auto parallel_trials(cj::string const& tnorm, size_t const trials, size_t const
   out
     << "Seed: " << seed << '\n'
     << "Tnorm: " << tnorm << '\n'
-    << "Trials: " << trials << '\n'
+    << "Folds: " << k << '\n'
+    << "Repeats: " << repeats << '\n'
     << "Sets / input variables: " << nsets << '\n'
+    << "Lookup table bits: " << lut_bits << '\n'
     << "Population size: " << pop_size << '\n'
     << "T(max): " << t_max << '\n'
     << "Alpha: " << alpha << '\n'
-    << "Mean complexity: " << mean_complexity << '\n'
-    << "Mean number of rules: " << mean_nrules << '\n'
+    << '\n';
+  for (auto f = 0u; f < folds.size(); ++f) {
+    out << "Repeat " << folds[f].repeat << ", fold " << folds[f].fold << ": Tss = " << results.tss[f] << '\n';
+  }
+  out
     << '\n'
-    << "Tss(initial): " << initial_tss << '\n'
-    << "Tss(evolved): " << evolved_tss << '\n'
-    << "Improvement: " << (evolved_tss - initial_tss) << '\n';
+    << "Tss(mean): " << results.mean_tss << '\n'
+    << "Tss(sd): " << results.sd_tss << '\n'
+    << "Tss(pooled): " << results.pooled.tss(1) << '\n';
 
   out.close();
 }
 
+// Result of one trial of a sweep.
+struct sweep_result {
+  size_t nsets;
+  double alpha;
+  cj::string tnorm;
+  double initial_tss;
+  double tss;
+  size_t complexity;
+  size_t nrules;
+};
+
+// Output of the trials of a sweep, written by the trials as they finish.
+struct sweep_output {
+  std::mutex mutex;
+  std::ofstream out;
+  cj::vector<sweep_result> results;
+};
+
+// Queues the trials of every (nsets, alpha, seed) of the grid for one logic. The data are fuzzified
+// once for each number of sets; the trials hold the prepared datasets until they are done.
+template<typename Truth>
+auto submit_sweep(cj::task_pool& pool, cj::string const& tnorm, cj::vector<uint32_t> const& nsets,
+                  cj::vector<double> const& alphas, cj::vector<size_t> const& seeds, size_t const lut_bits,
+                  size_t const pop_size, size_t const t_max, size_t const evolve_threads,
+                  island_settings const& is, cj::data_matrix_view<double, uint32_t> const& dm,
+                  cj::data_matrix_view<double, uint32_t> const& testing, sweep_output& so) -> void {
+  auto const own = size_t(cj::fuzzy_logic_of<Truth>::value);
+
+  for (auto const n : nsets) {
+    auto const training = prepared<Truth>::make(dm, make_interpretation<Truth>(n, lut_bits, dm));
+    auto const test = prepared<Truth>::make(testing, training->interpretation());
+    auto const initial_c = training->classifier({{{{0, 0}}, 0}, {{{0, 1}}, 1}});
+    auto const initial_tss = cj::evaluate_all_logics(initial_c, test->memberships())[own].tss(1);
+    for (auto const alpha : alphas) {
+      for (auto const s : seeds) {
+        pool.submit([=, &is, &so] {
+          auto const b = trial<Truth>(s, pop_size, t_max, alpha, evolve_threads, is, training);
+          auto const r = sweep_result{n, alpha, tnorm, initial_tss, b.evaluate_all(test->memberships()).tss(1),
+                                      b.complexity(), b.size()};
+          auto lock = std::lock_guard<std::mutex>{so.mutex};
+          so.out
+            << r.nsets << ',' << r.alpha << ',' << r.tnorm << ',' << s << ',' << r.initial_tss << ','
+            << r.tss << ',' << r.complexity << ',' << r.nrules << '\n' << std::flush;
+          so.results.push_back(r);
+        });
+      }
+    }
+  }
+}
+
+// Runs every trial of the nsets x alpha x logic x seed grid in this process, on a single pool of
+// 'threads' threads. Each trial is written as a line of '<filename_prefix>-<seed>.csv' once done,
+// and the mean of each configuration is printed at the end.
+auto sweep(cj::vector<cj::string> const& tnorms, cj::vector<uint32_t> const& nsets, cj::vector<double> const& alphas,
+           size_t const trials, size_t const threads, size_t const seed, size_t const lut_bits,
+           size_t const pop_size, size_t const t_max, size_t const evolve_threads, island_settings const& is,
+           cj::data_matrix_view<double, uint32_t> const& dm, cj::data_matrix_view<double, uint32_t> const& testing,
+           char const* filename_prefix) -> void {
+  auto rng = std::mt19937_64(seed);
+  auto seed_gen = std::uniform_int_distribution<size_t>{};
+
+  // The configurations are evolved from the same seeds:
+  auto seeds = cj::vector<size_t>{};
+  seeds.reserve(trials);
+  for (auto t = 0; t < trials; ++t) {
+    seeds.push_back(seed_gen(rng));
+  }
+
+  auto so = sweep_output{};
+  so.out.open(cj::string{filename_prefix} + cj::string{"-"} + boost::lexical_cast<cj::string>(seed) + cj::string{".csv"});
+  so.out << "nsets,alpha,tnorm,seed,tss_initial,tss,complexity,rules\n";
+
+  {
+    auto pool = cj::task_pool{threads / std::max(evolve_threads, size_t{1})};
+    for (auto const& tnorm : tnorms) {
+      if (tnorm == "Łukasiewicz") {
+        submit_sweep<cj::lukasiewicz<double>>(pool, tnorm, nsets, alphas, seeds, lut_bits, pop_size, t_max, evolve_threads, is, dm, testing, so);
+      } else if (tnorm == "Gödel-Dummett") {
+        submit_sweep<cj::godel<double>>(pool, tnorm, nsets, alphas, seeds, lut_bits, pop_size, t_max, evolve_threads, is, dm, testing, so);
+      } else { // "Product"
+        submit_sweep<cj::product<double>>(pool, tnorm, nsets, alphas, seeds, lut_bits, pop_size, t_max, evolve_threads, is, dm, testing, so);
+      }
+    }
+  } // Waits for all trials.
+  so.out.close();
+
+  for (auto const& tnorm : tnorms) {
+    for (auto const n : nsets) {
+      for (auto const alpha : alphas) {
+        auto initial_tss = 0.0;
+        auto tsses = cj::vector<double>{};
+        for (auto const& r : so.results) {
+          if (r.tnorm == tnorm && r.nsets == n && r.alpha == alpha) {
+            initial_tss = r.initial_tss;
+            tsses.push_back(r.tss);
+          }
+        }
+        std::cout
+          << tnorm << ", " << n << " sets, alpha = " << alpha << ": Tss(initial) = " << initial_tss
+          << ", Tss(evolved) = " << cj::fast_mean(tsses.begin(), tsses.end()) << '\n';
+      }
+    }
+  }
+}
+
+// Canonical name of a logic, or an empty string if the name is not valid.
+auto logic_of_name(cj::string const& name) -> cj::string {
+  if (name == "Łukasiewicz" || name == "Lukasiewicz") {
+    return "Łukasiewicz";
+  } else if (name == "Godel" || name == "Gödel" || name == "Gödel-Dummett") {
+    return "Gödel-Dummett";
+  } else if (name == "Product" || name == "All") {
+    return name;
+  }
+  return "";
+}
+
 auto main(int argc, char *argv[]) -> int {
   auto logic_name = cj::get_arg<cj::string>(argc, argv, "logic", cj::string{"Łukasiewicz"});
   auto const seed = cj::get_arg<size_t>(argc, argv, "seed", std::time(0));
   auto const trials = cj::get_arg<uint32_t>(argc, argv, "trials", 100);
-  auto const nsets = cj::get_arg<uint32_t>(argc, argv, "nsets", 5); // How many fuzzy sets for each variables.
+  // How many fuzzy sets for each variables (a list of values for a sweep):
+  auto const nsets_grid = cj::get_arg<uint32_t>(argc, argv, "nsets", cj::vector<uint32_t>{5});
+  auto const nsets = nsets_grid.empty()? 5 : nsets_grid.front();
   auto const pop_size = std::max(cj::get_arg<uint32_t>(argc, argv, "populations", 100), uint32_t{8});
   auto const t_max = std::max(cj::get_arg<uint32_t>(argc, argv, "steps", 10), uint32_t{100});
-  auto const alpha = cj::get_arg<double>(argc, argv, "alpha", 0.0005);
+  auto const alpha_grid = cj::get_arg<double>(argc, argv, "alpha", cj::vector<double>{0.0005});
+  auto const alpha = alpha_grid.empty()? 0.0005 : alpha_grid.front();
+  auto const evolve_threads = cj::get_arg<uint32_t>(argc, argv, "evolve-threads", 1); // Threads used by each trial.
+  auto const islands = island_settings {
+    cj::get_arg<uint32_t>(argc, argv, "islands", 1), // Populations evolved in parallel by each trial.
+    std::max(cj::get_arg<uint32_t>(argc, argv, "interval", 10), uint32_t{1}), // Generations between migrations.
+    cj::get_arg<uint32_t>(argc, argv, "migrants", 5), // Classifiers sent by each island.
+    cj::get_arg<cj::string>(argc, argv, "topology", cj::string{"ring"}) == "full"?
+      cj::migration_topology::fully_connected : cj::migration_topology::ring
+  };
+  auto const lut_bits = cj::get_arg<uint32_t>(argc, argv, "lut-bits", 0); // Lookup tables of 2^k entries (0: off).
   auto const ptest = 0.1;
-  auto const threads = std::thread::hardware_concurrency() + 1;
+  // Threads used by all trials together:
+  auto const threads = cj::get_arg<uint32_t>(argc, argv, "threads", std::max(std::thread::hardware_concurrency(), 1u));
 
   auto main_rng = std::mt19937_64(seed);
 
-  // Make sure the logic's name is valid:
-  if (logic_name != "Łukasiewicz") {
-    if (logic_name == "Godel" || logic_name == "Gödel" || logic_name == "Gödel-Dummett") {
-      logic_name = "Gödel-Dummett";
-    } else if (logic_name == "Product") {
+  std::cout << seed << '\n';
+
+  // Parsed once, then read from the binary cache written next to the CSV file:
+  auto data_ref = cj::load_cached<double, uint32_t>("../data/poll_plant/poll.csv");
+  if (!data_ref) {
+    std::cout << "ERROR: Failed to load data. You must execute this program in a folder with 'data/poll_plant/poll.csv'\n";
+    return 0;
+  }
+  // The data are loaded once: the training and testing sets are views of its rows.
+  auto const all = cj::data_matrix_view<double, uint32_t>{
+    std::make_shared<cj::data_matrix<double, uint32_t> const>(std::move(*data_ref))};
+
+  // Cross-validation on all the data: --cv=k folds, repeated --repeats times.
+  auto const cv = cj::get_arg<uint32_t>(argc, argv, "cv", 0);
+  if (cv > 1) {
+    auto const repeats = std::max(cj::get_arg<uint32_t>(argc, argv, "repeats", 1), uint32_t{1});
+    auto const l = logic_of_name(logic_name);
+    if (l == "Gödel-Dummett") {
+      cross_validation<cj::godel<double>>(l, cv, repeats, threads, seed, nsets, lut_bits, pop_size, t_max, alpha, evolve_threads, islands, all, "CV-Godel");
+    } else if (l == "Product") {
+      cross_validation<cj::product<double>>(l, cv, repeats, threads, seed, nsets, lut_bits, pop_size, t_max, alpha, evolve_threads, islands, all, "CV-Prod");
     } else {
-      if (logic_name != "Lukasiewicz") {
-        std::cout << "WARNING: Invalid logic name, defaulting to \"Łukasiewicz\".\n";
-      }
-      logic_name = "Łukasiewicz";
+      cross_validation<cj::lukasiewicz<double>>("Łukasiewicz", cv, repeats, threads, seed, nsets, lut_bits, pop_size, t_max, alpha, evolve_threads, islands, all, "CV-Luka");
     }
+    return 0;
   }
 
-  std::cout << seed << '\n';
+  auto const [data, test] = all.split(ptest, main_rng);
 
-  auto data_ref = cj::data_matrix<double, uint32_t>::from_file("../data/poll_plant/poll.csv");
-  if (!data_ref) {
-    std::cout << "ERROR: Failed to load data. You must execute this program in a folder with 'data/poll_plant/poll.csv'\n";
+  // Sweep: --nsets, --alpha and --logic take comma-separated lists, and each of the 'trials' seeds
+  // is evolved once for each point of the grid.
+  if (cj::get_arg<cj::string>(argc, argv, "sweep")) {
+    auto tnorms = cj::vector<cj::string>{};
+    for (auto const& name : cj::get_arg<cj::string>(argc, argv, "logic", cj::vector<cj::string>{"All"})) {
+      auto const l = logic_of_name(name);
+      if (l == "All") {
+        tnorms.insert(tnorms.end(), {"Łukasiewicz", "Gödel-Dummett", "Product"});
+      } else if (!l.empty()) {
+        tnorms.push_back(l);
+      }
+    }
+    sweep(tnorms, nsets_grid, alpha_grid, trials, threads, seed, lut_bits, pop_size, t_max, evolve_threads,
+          islands, data, test, "Sweep");
     return 0;
   }
-  auto data = *data_ref;
 
-  auto test = data.split_frame(ptest, main_rng);
+  // Make sure the logic's name is valid:
+  logic_name = logic_of_name(logic_name);
+  if (logic_name.empty()) {
+    std::cout << "WARNING: Invalid logic name, defaulting to \"Łukasiewicz\".\n";
+    logic_name = "Łukasiewicz";
+  }
 
-  if (logic_name == "Łukasiewicz") {
-    parallel_trials<cj::lukasiewicz<double>>("Łukasiewicz", trials, threads, seed, nsets, pop_size, t_max, alpha, data, test, "Luka");
+  // "All": the three logics are evolved in the same process, on the same data and split.
+  if (logic_name == "All") {
+    parallel_trials<cj::lukasiewicz<double>>("Łukasiewicz", trials, threads, seed, nsets, lut_bits, pop_size, t_max, alpha, evolve_threads, islands, data, test, "Luka");
+    parallel_trials<cj::godel<double>>("Gödel-Dummett", trials, threads, seed, nsets, lut_bits, pop_size, t_max, alpha, evolve_threads, islands, data, test, "Godel");
+    parallel_trials<cj::product<double>>("Product", trials, threads, seed, nsets, lut_bits, pop_size, t_max, alpha, evolve_threads, islands, data, test, "Prod");
+  } else if (logic_name == "Łukasiewicz") {
+    parallel_trials<cj::lukasiewicz<double>>("Łukasiewicz", trials, threads, seed, nsets, lut_bits, pop_size, t_max, alpha, evolve_threads, islands, data, test, "Luka");
   } else if (logic_name == "Gödel-Dummett") {
-    parallel_trials<cj::godel<double>>("Gödel-Dummett", trials, threads, seed, nsets, pop_size, t_max, alpha, data, test, "Godel");
+    parallel_trials<cj::godel<double>>("Gödel-Dummett", trials, threads, seed, nsets, lut_bits, pop_size, t_max, alpha, evolve_threads, islands, data, test, "Godel");
   } else { // "Product"
-    parallel_trials<cj::product<double>>("Product", trials, threads, seed, nsets, pop_size, t_max, alpha, data, test, "Prod");
+    parallel_trials<cj::product<double>>("Product", trials, threads, seed, nsets, lut_bits, pop_size, t_max, alpha, evolve_threads, islands, data, test, "Prod");
   }
 
   return 0;
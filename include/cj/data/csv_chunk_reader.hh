@@ -0,0 +1,206 @@
+/**
+ * # Summary
+ *
+ * Streaming of datasets larger than the memory: a CSV file is read by chunks of a fixed number of
+ * rows, each chunk replacing the previous one in the same data_matrix, so that the memory used
+ * does not depend on the size of the file.
+ */
+#ifndef CJ_DATA_CSV_CHUNK_READER_HH_
+#define CJ_DATA_CSV_CHUNK_READER_HH_
+
+#include <fstream>
+#include <stdexcept>
+#include "cj/common.hh"
+#include "cj/data/data_matrix.hh"
+
+namespace cj {
+
+  /**
+   * \brief Whether 'Source' yields chunks of rows (like csv_chunk_reader): it names the
+   *        'data_matrix_type' of its chunks, makes an empty chunk with 'make_chunk()', fills it
+   *        with 'next(chunk) -> bool', and starts over with 'rewind()'.
+   */
+  template<typename Source, typename = void>
+  struct is_chunk_source : std::false_type {};
+
+  template<typename Source>
+  struct is_chunk_source<Source, std::void_t<
+      typename Source::data_matrix_type,
+      decltype(std::declval<Source&>().make_chunk()),
+      decltype(std::declval<Source&>().next(std::declval<typename Source::data_matrix_type&>())),
+      decltype(std::declval<Source&>().rewind())>> : std::true_type {};
+
+  template<typename Source>
+  constexpr bool is_chunk_source_v = is_chunk_source<Source>::value;
+
+  /**
+   * \brief Reads the rows of a CSV file (in the format of data_matrix::from_file) by chunks of
+   *        'chunk_rows' rows. Only one chunk, and the block of the file being read, is in memory
+   *        at a time.
+   */
+  template<typename Input, typename Output>
+  class csv_chunk_reader {
+   public:
+    using input_type = Input;
+    using output_type = Output;
+    using data_matrix_type = data_matrix<input_type, output_type>;
+
+    /**
+     * \brief Opens a CSV file and reads its headers, or returns std::nullopt if the file cannot be
+     *        opened or has no headers.
+     *
+     * \param filename    CSV file, with the output in the last column.
+     * \param chunk_rows  Number of rows of each chunk (except the last one, which can be smaller).
+     * \param delim       Delimiter of the fields.
+     */
+    static auto open(char const* filename, size_t chunk_rows = size_t{1} << 16, char delim = ',')
+        -> std::optional<csv_chunk_reader<input_type, output_type>>;
+
+    /**
+     * \brief Number of rows of a chunk.
+     */
+    auto chunk_rows() const noexcept -> size_t {
+      return m_chunk_rows;
+    }
+
+    /**
+     * \brief Names of the input variables.
+     */
+    auto input_names() const noexcept -> vector<string> const& {
+      return m_input_names;
+    }
+
+    /**
+     * \brief Name of the output variable.
+     */
+    auto output_name() const noexcept -> string const& {
+      return m_output_name;
+    }
+
+    /**
+     * \brief An empty data_matrix with the headers of the file and room for a chunk, to be filled
+     *        by 'next'.
+     */
+    auto make_chunk() const -> data_matrix_type {
+      auto chunk = data_matrix_type{m_input_names, m_output_name};
+      chunk.reserve(m_chunk_rows);
+      return chunk;
+    }
+
+    /**
+     * \brief Replaces the rows of 'chunk' by the next rows of the file (at most 'chunk_rows').
+     *        Returns false, with an empty chunk, once all the rows have been read. Throws
+     *        std::runtime_error if a row is invalid.
+     */
+    auto next(data_matrix_type& chunk) -> bool;
+
+    /**
+     * \brief Goes back to the first row of the file.
+     */
+    auto rewind() -> void {
+      m_in.clear();
+      m_in.seekg(m_body);
+      m_buffer.clear();
+      m_pos = 0;
+    }
+
+   private:
+    csv_chunk_reader(std::ifstream in, size_t chunk_rows, char delim)
+      : m_in{std::move(in)}, m_chunk_rows{std::max(chunk_rows, size_t{1})}, m_delim{delim} {
+    }
+
+    /**
+     * \brief Appends the next block of the file to the buffer, dropping the rows already read.
+     *        Returns false at the end of the file.
+     */
+    auto fill() -> bool;
+
+    static constexpr size_t block_size = size_t{1} << 20;
+
+    std::ifstream m_in;
+    size_t m_chunk_rows;
+    char m_delim;
+    vector<string> m_input_names;
+    string m_output_name;
+    std::streampos m_body; // Position of the first row in the file.
+    string m_buffer; // Text read from the file and not yet parsed, from 'm_pos'.
+    size_t m_pos = 0;
+  };
+
+  // Definitions:
+
+  template<typename Input, typename Output>
+  auto csv_chunk_reader<Input, Output>::open(char const* filename, size_t chunk_rows, char delim)
+      -> std::optional<csv_chunk_reader<Input, Output>> {
+    auto in = std::ifstream{filename, std::ios::binary};
+    auto line = string{};
+    if (!in || !std::getline(in, line)) {
+      return std::nullopt;
+    }
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    auto headers = split(line, delim);
+    if (headers.empty()) {
+      return std::nullopt;
+    }
+    auto reader = csv_chunk_reader<Input, Output>{std::move(in), chunk_rows, delim};
+    reader.m_output_name = headers.back();
+    headers.pop_back();
+    reader.m_input_names = std::move(headers);
+    reader.m_body = reader.m_in.tellg();
+    return std::optional<csv_chunk_reader<Input, Output>>{std::move(reader)};
+  }
+
+  template<typename Input, typename Output>
+  auto csv_chunk_reader<Input, Output>::fill() -> bool {
+    m_buffer.erase(0, m_pos);
+    m_pos = 0;
+    if (!m_in) {
+      return false;
+    }
+    auto const size = m_buffer.size();
+    m_buffer.resize(size + block_size);
+    m_in.read(&m_buffer[size], std::streamsize(block_size));
+    m_buffer.resize(size + size_t(m_in.gcount()));
+    return m_buffer.size() > size;
+  }
+
+  template<typename Input, typename Output>
+  auto csv_chunk_reader<Input, Output>::next(data_matrix_type& chunk) -> bool {
+    chunk.clear();
+    // Finds the end of the chunk's rows in the buffer, reading more of the file as needed (empty
+    // lines are skipped, as by data_matrix::from_chars):
+    auto end = m_pos;
+    auto nrows = size_t{0};
+    while (nrows < m_chunk_rows) {
+      auto const first = m_buffer.data() + end;
+      auto const last = m_buffer.data() + m_buffer.size();
+      auto eol = static_cast<char const*>(std::memchr(first, '\n', size_t(last - first)));
+      if (eol == nullptr) {
+        auto const offset = end - m_pos;
+        if (fill()) {
+          end = m_pos + offset;
+          continue;
+        }
+        end = m_pos + offset;
+        if (end == m_buffer.size()) {
+          break;
+        }
+        eol = m_buffer.data() + m_buffer.size(); // Last row, without a line break.
+      }
+      auto const line_end = size_t(eol - m_buffer.data());
+      auto const empty = line_end == end || (line_end == end + 1 && m_buffer[end] == '\r');
+      nrows += empty? 0 : 1;
+      end = std::min(line_end + 1, m_buffer.size());
+    }
+    if (!chunk.append_chars(m_buffer.data() + m_pos, m_buffer.data() + end, m_delim)) {
+      throw std::runtime_error("csv_chunk_reader: invalid row");
+    }
+    m_pos = end;
+    return chunk.nrows() > 0;
+  }
+
+} /* end namespace cj */
+
+#endif
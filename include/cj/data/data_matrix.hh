@@ -1,9 +1,9 @@
 /**
  * # Summary
  *
- * A simple row-based class for supervised learning. It stores data as a vector of rows (without
- * missing values), with each row being represented by a vector along with its output (of
- * potentially a different type).
+ * A simple class for supervised learning. It stores data by column (without missing values): each
+ * input variable is a contiguous array, and the outputs (of potentially a different type) are
+ * stored in another array. Rows are accessed through lightweight proxies.
  *
  */
 #ifndef CJ_DATA_DATA_MATRIX_HH_
@@ -11,29 +11,188 @@
 
 #include <iostream>
 #include <sstream>
+#include <charconv>
+#include <numeric>
+#include <cstring>
+#include <thread>
 #include "cj/common.hh"
 #include "cj/utils/string.hh"
+#include "cj/utils/span.hh"
+#include "cj/utils/mapped_file.hh"
+#include "cj/utils/parallel.hh"
 #include "cj/math/random.hh"
 
 namespace cj {
 
+  namespace detail {
+
+    /**
+     * \brief Parses a whole field, ignoring the spaces around it. Numbers are parsed in place with
+     *        std::from_chars, other types with boost::lexical_cast.
+     */
+    template<typename T>
+    auto parse_field(char const* first, char const* last, T& value) -> bool {
+      while (first != last && (*first == ' ' || *first == '\t')) {
+        ++first;
+      }
+      while (last != first && (last[-1] == ' ' || last[-1] == '\t')) {
+        --last;
+      }
+      if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+        if (first != last && *first == '+') {
+          ++first;
+        }
+        auto const res = std::from_chars(first, last, value);
+        return res.ec == std::errc{} && res.ptr == last;
+      } else {
+        return boost::conversion::try_lexical_convert(string(first, last), value);
+      }
+    }
+
+    /**
+     * \brief Calls f(first, last) for each non-empty line of [first, last), without the line
+     *        break (\n or \r\n).
+     */
+    template<typename F>
+    auto for_each_line(char const* first, char const* last, F const& f) -> void {
+      while (first < last) {
+        auto eol = static_cast<char const*>(std::memchr(first, '\n', size_t(last - first)));
+        auto const next = eol == nullptr? last : eol + 1;
+        if (eol == nullptr) {
+          eol = last;
+        }
+        if (eol != first && eol[-1] == '\r') {
+          --eol;
+        }
+        if (eol != first) {
+          f(first, eol);
+        }
+        first = next;
+      }
+    }
+
+  } /* end namespace detail */
+
   /**
-   * \brief A data_matrix is a vector of rows, each also represented as vectors of data, along with a vector of names (the headers).
+   * \brief Random-access iterator over the rows of a data_matrix (or of a view), dereferencing to
+   *        a row proxy.
+   */
+  template<typename Rows>
+  class row_iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename Rows::row_reference;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    row_iterator() noexcept : m_rows{nullptr}, m_pos{0} {
+    }
+
+    row_iterator(Rows const* rows, size_t pos) noexcept : m_rows{rows}, m_pos{pos} {
+    }
+
+    auto operator*() const -> reference {
+      return (*m_rows)(m_pos);
+    }
+
+    auto operator[](difference_type n) const -> reference {
+      return (*m_rows)(m_pos + n);
+    }
+
+    auto operator++() noexcept -> row_iterator& {
+      ++m_pos;
+      return *this;
+    }
+
+    auto operator++(int) noexcept -> row_iterator {
+      auto const it = *this;
+      ++m_pos;
+      return it;
+    }
+
+    auto operator--() noexcept -> row_iterator& {
+      --m_pos;
+      return *this;
+    }
+
+    auto operator--(int) noexcept -> row_iterator {
+      auto const it = *this;
+      --m_pos;
+      return it;
+    }
+
+    auto operator+=(difference_type n) noexcept -> row_iterator& {
+      m_pos += n;
+      return *this;
+    }
+
+    auto operator-=(difference_type n) noexcept -> row_iterator& {
+      m_pos -= n;
+      return *this;
+    }
+
+    auto operator+(difference_type n) const noexcept -> row_iterator {
+      return row_iterator{m_rows, m_pos + n};
+    }
+
+    auto operator-(difference_type n) const noexcept -> row_iterator {
+      return row_iterator{m_rows, m_pos - n};
+    }
+
+    auto operator-(row_iterator const& other) const noexcept -> difference_type {
+      return difference_type(m_pos) - difference_type(other.m_pos);
+    }
+
+    auto operator==(row_iterator const& other) const noexcept -> bool {
+      return m_pos == other.m_pos;
+    }
+
+    auto operator!=(row_iterator const& other) const noexcept -> bool {
+      return m_pos != other.m_pos;
+    }
+
+    auto operator<(row_iterator const& other) const noexcept -> bool {
+      return m_pos < other.m_pos;
+    }
+
+   private:
+    Rows const* m_rows;
+    size_t m_pos;
+  };
+
+  /**
+   * \brief A data_matrix stores each input variable in its own contiguous array, along with the
+   *        array of the outputs and a vector of names (the headers).
    */
   template<typename Input, typename Output>
   class data_matrix {
    public:
+    class row_inputs;
+
     using input_type = Input;
     using output_type = Output;
-    using row_type = pair<vector<input_type>, output_type>;
-    using data_matrix_type = vector<row_type>;
-    using const_iterator = typename data_matrix_type::const_iterator;
+    using row_type = pair<vector<input_type>, output_type>; // A row as it is added.
+    using row_reference = pair<row_inputs, output_type>; // A row as it is read.
+    using column_type = std::vector<input_type, Eigen::aligned_allocator<input_type>>;
+    using const_iterator = row_iterator<data_matrix<input_type, output_type>>;
 
     /**
      * \brief Constructs an empty data_matrix with a set of headers.
      */
     data_matrix(vector<string> const& headers, string const& output)
-      : m_headers(headers), m_output_name(output) {
+      : m_columns(headers.size()), m_headers(headers), m_output_name(output) {
+    }
+
+    /**
+     * \brief Constructs a data_matrix from its columns, which must all have as many values as
+     *        'outputs'.
+     */
+    data_matrix(vector<string> const& headers, string const& output, vector<column_type> columns,
+                vector<output_type> outputs)
+      : m_columns(std::move(columns)), m_outputs(std::move(outputs)), m_headers(headers),
+        m_output_name(output) {
+      assert(m_columns.size() == m_headers.size());
     }
 
     /**
@@ -47,21 +206,21 @@ namespace cj {
      * \brief Returns the number of rows.
      */
     auto nrows() const noexcept -> size_t {
-      return m_dm.size();
+      return m_outputs.size();
     }
 
     /**
      * \brief Returns the number of rows.
      */
     auto size() const noexcept -> size_t {
-      return m_dm.size();
+      return m_outputs.size();
     }
 
     /**
      * \brief Whether the data_matrix has no entries (i.e. size() == 0).
      */
     auto empty() const noexcept -> bool {
-      return m_dm.empty();
+      return m_outputs.empty();
     }
 
     /**
@@ -90,27 +249,58 @@ namespace cj {
       return m_output_name;
     }
 
+    /**
+     * \brief Removes all the rows, keeping the headers and the memory.
+     */
+    auto clear() noexcept -> void {
+      for (auto& c : m_columns) {
+        c.clear();
+      }
+      m_outputs.clear();
+    }
+
     /**
      * \brief Reserves memory for a number of rows.
      */
     auto reserve(size_t n) -> void {
-      m_dm.reserve(n);
+      for (auto& c : m_columns) {
+        c.reserve(n);
+      }
+      m_outputs.reserve(n);
     }
 
     /**
-     * \brief Returns an empty vector if the name of the col is invalid.
+     * \brief Contiguous values of the nth input variable.
      */
-    auto extract_column(string const& col) const noexcept -> vector<input_type>;
+    auto column(size_t n) const -> span<input_type> {
+      auto const& c = m_columns.at(n);
+      return span<input_type>{c.data(), c.size()};
+    }
+
+    /**
+     * \brief Contiguous outputs of the rows.
+     */
+    auto outputs() const noexcept -> span<output_type> {
+      return span<output_type>{m_outputs.data(), m_outputs.size()};
+    }
+
+    /**
+     * \brief Values of an input variable given its name (no copy). Returns an empty span if the
+     *        name of the col is invalid.
+     */
+    auto extract_column(string const& col) const noexcept -> span<input_type>;
 
     /**
      * \brief Get the output associated with a given row.
      */
     auto get_output(size_t row) const -> output_type {
-      return m_dm.at(row).second;
+      return m_outputs.at(row);
     }
 
     /**
-     * \brief Split x% of the current data_matrix into a new data_matrix.
+     * \brief Split x% of the current data_matrix into a new data_matrix. The rows are moved out
+     *        of this data_matrix: see data_matrix_view::split to split without copying nor
+     *        modifying the rows.
      */
     auto split_frame(double prop, std::mt19937_64 &rng) -> data_matrix<input_type, output_type>;
 
@@ -131,28 +321,28 @@ namespace cj {
      * \brief Iterator to the beginning of the rows.
      */
     auto begin() const noexcept -> const_iterator {
-      return m_dm.begin();
+      return const_iterator{this, 0};
     }
 
     /**
      * \brief Iterator to the end of the rows.
      */
     auto end() const noexcept -> const_iterator {
-      return m_dm.end();
+      return const_iterator{this, nrows()};
     }
 
     /**
-     * \brief Returns a reference to a row.
+     * \brief Returns a proxy to a row: its inputs (read from the columns) and its output.
      */
-    auto operator()(size_t row) const -> row_type const& {
-      return m_dm.at(row);
+    auto operator()(size_t row) const -> row_reference {
+      return row_reference{row_inputs{this, row}, m_outputs.at(row)};
     }
 
     /**
      * \brief Returns a value for a given row and column.
      */
     auto operator()(size_t row, size_t col) const -> input_type {
-      return m_dm.at(row).first.at(col);
+      return m_columns.at(col).at(row);
     }
 
 //    /**
@@ -162,101 +352,255 @@ namespace cj {
 //      return m_dm.at(row).first.at(m_str_to_idx.at(col));
 //    }
 
-    static auto from_str(string const& txt, char delim = ',') -> std::optional<data_matrix<input_type, output_type>>;
+    /**
+     * \brief Constructs a data_matrix from CSV text: a line of headers (the last one naming the
+     *        output) followed by one line per row. Empty lines are skipped. Returns std::nullopt
+     *        if a row has the wrong number of fields or a field cannot be parsed.
+     *
+     * \param txt       The text.
+     * \param delim     Delimiter between the fields.
+     * \param threads   Number of threads parsing the rows (0: as many as the hardware supports if
+     *                  the text is large, 1 otherwise).
+     */
+    static auto from_str(string const& txt, char delim = ',', size_t threads = 0) -> std::optional<data_matrix<input_type, output_type>> {
+      return from_chars(txt.data(), txt.data() + txt.size(), delim, threads);
+    }
 
     /**
-     * \brief Constructs a data_matrix from a file.
+     * \brief Constructs a data_matrix from a CSV file, which is mapped in memory and parsed in place
+     *        (see from_str).
      */
-    static auto from_file(char const* filename, char delim = ',') -> std::optional<data_matrix<input_type, output_type>>;
+    static auto from_file(char const* filename, char delim = ',', size_t threads = 0) -> std::optional<data_matrix<input_type, output_type>>;
+
+    /**
+     * \brief Constructs a data_matrix from the CSV text in [first, last) (see from_str). The text
+     *        is split in chunks at line breaks, and each chunk is parsed on its own thread straight
+     *        into the columns.
+     */
+    static auto from_chars(char const* first, char const* last, char delim = ',', size_t threads = 0) -> std::optional<data_matrix<input_type, output_type>>;
+
+    /**
+     * \brief Appends the rows of CSV text without headers (see from_chars). Returns false, leaving
+     *        the data_matrix unchanged, if a row is invalid.
+     */
+    auto append_chars(char const* first, char const* last, char delim = ',', size_t threads = 0) -> bool;
 
    private:
-    data_matrix_type m_dm;
+    vector<column_type> m_columns; // One array per input variable.
+    vector<output_type> m_outputs;
     vector<string> m_headers;
     string m_output_name;
   };
 
+  /**
+   * \brief The inputs of a row of a data_matrix, read from the columns. Indexed like a vector of
+   *        inputs; the data_matrix must outlive it.
+   */
+  template<typename Input, typename Output>
+  class data_matrix<Input, Output>::row_inputs {
+   public:
+    row_inputs(data_matrix const* dm, size_t row) noexcept : m_dm{dm}, m_row{row} {
+    }
+
+    /**
+     * \brief Number of inputs.
+     */
+    auto size() const noexcept -> size_t {
+      return m_dm->m_columns.size();
+    }
+
+    auto operator[](size_t n) const -> input_type const& {
+      return m_dm->m_columns[n][m_row];
+    }
+
+    auto at(size_t n) const -> input_type const& {
+      return m_dm->m_columns.at(n).at(m_row);
+    }
+
+    /**
+     * \brief Index of the row in the data_matrix.
+     */
+    auto row() const noexcept -> size_t {
+      return m_row;
+    }
+
+    /**
+     * \brief Copies the inputs.
+     */
+    auto to_vector() const -> vector<input_type> {
+      auto xs = vector<input_type>{};
+      xs.reserve(size());
+      for (auto const& c : m_dm->m_columns) {
+        xs.push_back(c[m_row]);
+      }
+      return xs;
+    }
+
+   private:
+    data_matrix const* m_dm;
+    size_t m_row;
+  };
+
   // Definitions:
 
   template<typename Input, typename Output>
   auto data_matrix<Input, Output>::add_row(typename data_matrix<Input, Output>::row_type const& new_row) noexcept -> bool {
     if (new_row.first.size() == m_headers.size()) {
-      m_dm.push_back(new_row);
+      for (auto n = size_t{0}; n < m_columns.size(); ++n) {
+        m_columns[n].push_back(new_row.first[n]);
+      }
+      m_outputs.push_back(new_row.second);
       return true;
     }
     return false;
   }
 
-//  template<typename Input, typename Output>
-//  auto data_matrix<Input, Output>::extract_column(string const& col) const noexcept -> vector<Input> {
-//    auto c = vector<Input>{};
-//    auto const it = m_str_to_idx.find(col);
-//    if (it == m_str_to_idx.end()) {
-//      return c;
-//    }
-//    size_t const idx = *it;
-//    c.reserve(m_dm.size());
-//    for (auto const& row : m_dm) {
-//      c.push_back(row.at(idx));
-//    }
-//    return c;
-//  }
+  template<typename Input, typename Output>
+  auto data_matrix<Input, Output>::extract_column(string const& col) const noexcept -> span<Input> {
+    auto const it = std::find(m_headers.begin(), m_headers.end(), col);
+    if (it == m_headers.end()) {
+      return span<Input>{};
+    }
+    auto const& c = m_columns[size_t(std::distance(m_headers.begin(), it))];
+    return span<Input>{c.data(), c.size()};
+  }
 
   template<typename Input, typename Output>
   auto data_matrix<Input, Output>::split_frame(double prop, std::mt19937_64 &rng) -> data_matrix<Input, Output> {
     auto new_df = data_matrix<Input, Output>(m_headers, m_output_name);
     auto const n = size_t(std::round(prop * nrows()));
-    auto const indexes = unique_integers<size_t>(n, size_t(0), nrows(), rng);
+    auto const indexes = sample_indices(n, nrows(), rng);
+    auto selected = vector<bool>(nrows(), false);
+    new_df.reserve(indexes.size());
     for (auto const i : indexes) {
-      new_df.add_row(m_dm[i]);
+      selected[i] = true;
+      for (auto c = size_t{0}; c < m_columns.size(); ++c) {
+        new_df.m_columns[c].push_back(m_columns[c][i]);
+      }
+      new_df.m_outputs.push_back(m_outputs[i]);
     }
-    for (auto it = indexes.rbegin(); it != indexes.rend(); ++it) {
-      m_dm.erase(m_dm.begin() + *it);
+    // The remaining rows are moved up in one pass over each column:
+    auto const compact = [&selected](auto& values) {
+      auto kept = size_t{0};
+      for (auto r = size_t{0}; r < values.size(); ++r) {
+        if (!selected[r]) {
+          values[kept++] = values[r];
+        }
+      }
+      values.resize(kept);
+    };
+    for (auto& c : m_columns) {
+      compact(c);
     }
+    compact(m_outputs);
     return new_df;
   }
 
   template<typename Input, typename Output>
   auto data_matrix<Input, Output>::one_per_line(std::ostream& os, string const& sep) const noexcept -> std::ostream& {
-    os << intersperse(m_headers.begin(), m_headers.end(), sep) << '\n';
-    for (auto const& row : m_dm) {
-      os << intersperse(row.begin(), row.end(), sep) << '\n';
+    os << intersperse(m_headers.begin(), m_headers.end(), sep) << sep << m_output_name << '\n';
+    for (auto r = size_t{0}; r < nrows(); ++r) {
+      for (auto const& c : m_columns) {
+        os << c[r] << sep;
+      }
+      os << m_outputs[r] << '\n';
     }
     return os;
   }
 
   template<typename Input, typename Output>
-  auto data_matrix<Input, Output>::from_str(string const& txt, char delim) -> std::optional<data_matrix<Input, Output>> {
-    auto lines = split(txt, '\n');
-    auto headers = split(lines[0], delim);
-    auto const output_name = headers.back();
-    headers.pop_back();
-    auto const ncols = headers.size() + 1;
-    if (ncols == 0) {
+  auto data_matrix<Input, Output>::from_chars(char const* first, char const* last, char delim, size_t threads) -> std::optional<data_matrix<Input, Output>> {
+    if (first == last) {
+      return std::nullopt;
+    }
+    // Headers:
+    auto header_end = static_cast<char const*>(std::memchr(first, '\n', size_t(last - first)));
+    auto const body = header_end == nullptr? last : header_end + 1;
+    if (header_end == nullptr) {
+      header_end = last;
+    }
+    if (header_end != first && header_end[-1] == '\r') {
+      --header_end;
+    }
+    auto headers = split(string(first, header_end), delim);
+    if (headers.empty()) {
       return std::nullopt;
     }
+    auto const output_name = headers.back();
+    headers.pop_back();
     auto dm = data_matrix<Input, Output>{headers, output_name};
-    dm.reserve(lines.size() - 1);
-    for (auto i = 1u; i < lines.size(); ++i) {
-      auto new_row = typename data_matrix<Input, Output>::row_type{};
-      new_row.first.reserve(ncols - 1);
-      auto columns = split(lines[i], delim);
-      new_row.second = boost::lexical_cast<Output>(columns.back());
-      if (columns.size() != ncols) {
-        return std::nullopt;
-      }
-      columns.pop_back();
-      for (auto const& c : columns) {
-        new_row.first.push_back(boost::lexical_cast<Input>(c));
+    return dm.append_chars(body, last, delim, threads)? std::optional<data_matrix<Input, Output>>{std::move(dm)}
+                                                       : std::nullopt;
+  }
+
+  template<typename Input, typename Output>
+  auto data_matrix<Input, Output>::append_chars(char const* first, char const* last, char delim, size_t threads) -> bool {
+    auto const ninputs = m_columns.size();
+    auto const nprevious = nrows();
+
+    // Chunks of at least 64KiB, starting after a line break:
+    constexpr auto min_chunk = size_t{1} << 16;
+    auto const bytes = size_t(last - first);
+    if (threads == 0) {
+      threads = bytes >= (size_t{1} << 20)? std::max(std::thread::hardware_concurrency(), 1u) : 1;
+    }
+    auto const nchunks = std::max(std::min(threads, bytes / min_chunk), size_t{1});
+    auto bounds = vector<char const*>{first};
+    for (auto k = size_t{1}; k < nchunks; ++k) {
+      auto p = std::max(first + k * bytes / nchunks, bounds.back());
+      auto const eol = static_cast<char const*>(std::memchr(p, '\n', size_t(last - p)));
+      bounds.push_back(eol == nullptr? last : eol + 1);
+    }
+    bounds.push_back(last);
+
+    // The rows of each chunk are counted to find where the chunk starts in the columns:
+    auto starts = vector<size_t>(nchunks + 1, 0);
+    starts[0] = nprevious;
+    parallel_for(nchunks, nchunks, [&](size_t k) {
+      detail::for_each_line(bounds[k], bounds[k + 1], [&](char const*, char const*) { ++starts[k + 1]; });
+    });
+    std::partial_sum(starts.begin(), starts.end(), starts.begin());
+    for (auto& c : m_columns) {
+      c.resize(starts.back());
+    }
+    m_outputs.resize(starts.back());
+
+    auto valid = vector<char>(nchunks, 1);
+    parallel_for(nchunks, nchunks, [&](size_t k) {
+      auto row = starts[k];
+      detail::for_each_line(bounds[k], bounds[k + 1], [&](char const* p, char const* eol) {
+        if (!valid[k]) {
+          return;
+        }
+        for (auto n = size_t{0}; n < ninputs; ++n) {
+          auto const end = static_cast<char const*>(std::memchr(p, delim, size_t(eol - p)));
+          if (end == nullptr || !detail::parse_field(p, end, m_columns[n][row])) {
+            valid[k] = 0;
+            return;
+          }
+          p = end + 1;
+        }
+        if (!detail::parse_field(p, eol, m_outputs[row])) {
+          valid[k] = 0; // Includes rows with too many fields.
+          return;
+        }
+        ++row;
+      });
+    });
+    if (std::find(valid.begin(), valid.end(), 0) != valid.end()) {
+      for (auto& c : m_columns) {
+        c.resize(nprevious);
       }
-      dm.add_row(new_row);
+      m_outputs.resize(nprevious);
+      return false;
     }
-    return dm;
+    return true;
   }
 
   template<typename Input, typename Output>
-  auto data_matrix<Input, Output>::from_file(char const* filename, char delim) -> std::optional<data_matrix<Input, Output>> {
-    auto content = read_file(filename);
-    return !content? std::nullopt : data_matrix<Input, Output>::from_str(*content, delim);
+  auto data_matrix<Input, Output>::from_file(char const* filename, char delim, size_t threads) -> std::optional<data_matrix<Input, Output>> {
+    auto const f = mapped_file::open(filename);
+    return !f? std::nullopt : data_matrix<Input, Output>::from_chars(f->data(), f->data() + f->size(), delim, threads);
   }
 
   template<typename Input, typename Output>
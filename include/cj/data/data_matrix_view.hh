@@ -0,0 +1,285 @@
+/**
+ * # Summary
+ *
+ * A view of some rows of a data_matrix, selected by index, that is used like a data_matrix
+ * without copying the rows (e.g. the folds of a cross-validation). Splits, bootstrap samples,
+ * stratified samples and subsamples are views of the same rows, so that a dataset is loaded once
+ * and never copied nor modified.
+ */
+#ifndef CJ_DATA_DATA_MATRIX_VIEW_HH_
+#define CJ_DATA_DATA_MATRIX_VIEW_HH_
+
+#include <numeric>
+#include "cj/common.hh"
+#include "cj/data/data_matrix.hh"
+#include "cj/math/random.hh"
+
+namespace cj {
+
+  /**
+   * \brief Rows of a data_matrix given by their indices, which can repeat. The view holds the
+   *        indices, and either a shared pointer to the (immutable) data_matrix, or a plain
+   *        reference to it, in which case the data_matrix must outlive the view and its samples.
+   */
+  template<typename Input, typename Output>
+  class data_matrix_view {
+   public:
+    using input_type = Input;
+    using output_type = Output;
+    using data_matrix_type = data_matrix<input_type, output_type>;
+    using row_type = typename data_matrix_type::row_type;
+    using row_reference = typename data_matrix_type::row_reference;
+    using const_iterator = row_iterator<data_matrix_view<input_type, output_type>>;
+    using matrix_ptr = std::shared_ptr<data_matrix_type const>;
+
+    /**
+     * \brief Views all the rows of a data_matrix.
+     */
+    explicit data_matrix_view(data_matrix_type const& dm)
+      : m_dm{&dm}, m_indices(dm.nrows()) {
+      std::iota(m_indices.begin(), m_indices.end(), size_t{0});
+    }
+
+    /**
+     * \brief Views the rows of a data_matrix at the given indices, in that order.
+     */
+    data_matrix_view(data_matrix_type const& dm, vector<size_t> indices)
+      : m_dm{&dm}, m_indices(std::move(indices)) {
+    }
+
+    /**
+     * \brief Views all the rows of a shared data_matrix, which lives as long as the view or any
+     *        of its samples.
+     */
+    explicit data_matrix_view(matrix_ptr dm)
+      : data_matrix_view{*dm} {
+      m_owner = std::move(dm);
+    }
+
+    /**
+     * \brief Views the rows of a shared data_matrix at the given indices, in that order.
+     */
+    data_matrix_view(matrix_ptr dm, vector<size_t> indices)
+      : data_matrix_view{*dm, std::move(indices)} {
+      m_owner = std::move(dm);
+    }
+
+    /**
+     * \brief Returns the number of columns (counting the output).
+     */
+    auto ncols() const noexcept -> size_t {
+      return m_dm->ncols();
+    }
+
+    /**
+     * \brief Returns the number of rows.
+     */
+    auto nrows() const noexcept -> size_t {
+      return m_indices.size();
+    }
+
+    /**
+     * \brief Returns the number of rows.
+     */
+    auto size() const noexcept -> size_t {
+      return m_indices.size();
+    }
+
+    /**
+     * \brief Whether the view has no rows.
+     */
+    auto empty() const noexcept -> bool {
+      return m_indices.empty();
+    }
+
+    /**
+     * \brief Returns a reference to the headers of the data_matrix.
+     */
+    auto input_names() const noexcept -> vector<string> const& {
+      return m_dm->input_names();
+    }
+
+    /**
+     * \brief Returns the name of the nth input variable.
+     */
+    auto input_name(size_t n) const noexcept -> string const& {
+      return m_dm->input_name(n);
+    }
+
+    /**
+     * \brief Returns the name of the output variable.
+     */
+    auto output_name() const noexcept -> string const& {
+      return m_dm->output_name();
+    }
+
+    /**
+     * \brief The viewed data_matrix.
+     */
+    auto matrix() const noexcept -> data_matrix_type const& {
+      return *m_dm;
+    }
+
+    /**
+     * \brief Indices in the data_matrix of the rows of the view.
+     */
+    auto indices() const noexcept -> vector<size_t> const& {
+      return m_indices;
+    }
+
+    /**
+     * \brief Get the output associated with a given row of the view.
+     */
+    auto get_output(size_t row) const -> output_type {
+      return m_dm->get_output(m_indices.at(row));
+    }
+
+    /**
+     * \brief Iterator to the beginning of the rows.
+     */
+    auto begin() const noexcept -> const_iterator {
+      return const_iterator{this, 0};
+    }
+
+    /**
+     * \brief Iterator to the end of the rows.
+     */
+    auto end() const noexcept -> const_iterator {
+      return const_iterator{this, nrows()};
+    }
+
+    /**
+     * \brief Returns a proxy to a row of the view.
+     */
+    auto operator()(size_t row) const -> row_reference {
+      return (*m_dm)(m_indices.at(row));
+    }
+
+    /**
+     * \brief Returns a value for a given row of the view and column.
+     */
+    auto operator()(size_t row, size_t col) const -> input_type {
+      return (*m_dm)(m_indices.at(row), col);
+    }
+
+    /**
+     * \brief View of some rows of this view, given by their indices in the view.
+     */
+    auto select(vector<size_t> const& rows) const -> data_matrix_view;
+
+    /**
+     * \brief Splits the rows in two views without copying them: a random proportion 'prop' of
+     *        the rows (e.g. the testing set) and the other rows (e.g. the training set), both in
+     *        the order of this view. Returns the pair (other rows, sampled rows), the same split
+     *        as data_matrix::split_frame for the same random generator.
+     */
+    auto split(double prop, std::mt19937_64& rng) const -> pair<data_matrix_view, data_matrix_view>;
+
+    /**
+     * \brief Like 'split', but the proportion 'prop' is sampled among the rows of each output
+     *        separately, so that both views have (nearly) the proportions of outputs of this one.
+     */
+    auto stratified_split(double prop, std::mt19937_64& rng) const -> pair<data_matrix_view, data_matrix_view>;
+
+    /**
+     * \brief Bootstrap sample: 'n' rows drawn with replacement.
+     */
+    auto bootstrap(size_t n, std::mt19937_64& rng) const -> data_matrix_view;
+
+    /**
+     * \brief 'n' distinct rows drawn at random (all the rows if 'n' is larger than the view), in
+     *        the order of this view.
+     */
+    auto subsample(size_t n, std::mt19937_64& rng) const -> data_matrix_view;
+
+   private:
+    /**
+     * \brief Splits the rows in two views given which ones are selected.
+     */
+    auto partition(vector<bool> const& selected) const -> pair<data_matrix_view, data_matrix_view>;
+
+    data_matrix_type const* m_dm;
+    vector<size_t> m_indices;
+    matrix_ptr m_owner; // Keeps the data_matrix alive (or null if the view does not own it).
+  };
+
+  // Definitions:
+
+  template<typename Input, typename Output>
+  auto data_matrix_view<Input, Output>::select(vector<size_t> const& rows) const -> data_matrix_view {
+    auto v = *this;
+    v.m_indices.resize(rows.size());
+    for (auto k = size_t{0}; k < rows.size(); ++k) {
+      v.m_indices[k] = m_indices.at(rows[k]);
+    }
+    return v;
+  }
+
+  template<typename Input, typename Output>
+  auto data_matrix_view<Input, Output>::partition(vector<bool> const& selected) const
+      -> pair<data_matrix_view, data_matrix_view> {
+    auto others = *this;
+    auto sampled = *this;
+    others.m_indices.clear();
+    sampled.m_indices.clear();
+    for (auto r = size_t{0}; r < m_indices.size(); ++r) {
+      (selected[r]? sampled : others).m_indices.push_back(m_indices[r]);
+    }
+    return {std::move(others), std::move(sampled)};
+  }
+
+  template<typename Input, typename Output>
+  auto data_matrix_view<Input, Output>::split(double prop, std::mt19937_64& rng) const
+      -> pair<data_matrix_view, data_matrix_view> {
+    auto const n = size_t(std::round(prop * nrows()));
+    auto selected = vector<bool>(nrows(), false);
+    for (auto const r : sample_indices(n, nrows(), rng)) {
+      selected[r] = true;
+    }
+    return partition(selected);
+  }
+
+  template<typename Input, typename Output>
+  auto data_matrix_view<Input, Output>::stratified_split(double prop, std::mt19937_64& rng) const
+      -> pair<data_matrix_view, data_matrix_view> {
+    auto by_output = ordered_map<output_type, vector<size_t>>{};
+    for (auto r = size_t{0}; r < nrows(); ++r) {
+      by_output[m_dm->get_output(m_indices[r])].push_back(r);
+    }
+    auto selected = vector<bool>(nrows(), false);
+    for (auto const& rows : by_output) {
+      auto const n = size_t(std::round(prop * rows.second.size()));
+      for (auto const k : sample_indices(n, rows.second.size(), rng)) {
+        selected[rows.second[k]] = true;
+      }
+    }
+    return partition(selected);
+  }
+
+  template<typename Input, typename Output>
+  auto data_matrix_view<Input, Output>::bootstrap(size_t n, std::mt19937_64& rng) const -> data_matrix_view {
+    auto v = *this;
+    v.m_indices.clear();
+    if (!empty()) {
+      auto dist = std::uniform_int_distribution<size_t>(0, nrows() - 1);
+      v.m_indices.reserve(n);
+      for (auto k = size_t{0}; k < n; ++k) {
+        v.m_indices.push_back(m_indices[dist(rng)]);
+      }
+    }
+    return v;
+  }
+
+  template<typename Input, typename Output>
+  auto data_matrix_view<Input, Output>::subsample(size_t n, std::mt19937_64& rng) const -> data_matrix_view {
+    auto v = *this;
+    v.m_indices.clear();
+    for (auto const r : sample_indices(n, nrows(), rng)) {
+      v.m_indices.push_back(m_indices[r]);
+    }
+    return v;
+  }
+
+} /* end namespace cj */
+
+#endif
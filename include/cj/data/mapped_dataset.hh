@@ -0,0 +1,397 @@
+/**
+ * # Summary
+ *
+ * Binary format of a data_matrix, read by mapping the file in memory instead of parsing text. The
+ * file holds a header (types, sizes and column names), then every input column and the output
+ * column as contiguous arrays aligned on 64 bytes, in the native byte order:
+ *
+ *     "CJDM" | byte order | version | input type | output type | delimiter of the source
+ *     number of rows | number of inputs | size of the source | modification time of the source
+ *     names of the inputs and of the output (length, characters)
+ *     input columns (rows x type)... | output column
+ *
+ * A CSV file is converted once by load_cached, which writes the binary file next to it and reads
+ * it back as long as the CSV file is unchanged.
+ */
+#ifndef CJ_DATA_MAPPED_DATASET_HH_
+#define CJ_DATA_MAPPED_DATASET_HH_
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "cj/common.hh"
+#include "cj/data/data_matrix.hh"
+#include "cj/utils/mapped_file.hh"
+#include "cj/utils/span.hh"
+
+namespace cj {
+
+  /**
+   * \brief Identifies a version of a source file by its size and modification time.
+   */
+  struct source_stamp {
+    uint64_t size = 0;
+    int64_t time = 0;
+
+    /**
+     * \brief The stamp of a file, or std::nullopt if it does not exist.
+     */
+    static auto of(char const* filename) -> std::optional<source_stamp> {
+      auto ec = std::error_code{};
+      auto const size = std::filesystem::file_size(filename, ec);
+      if (ec) {
+        return std::nullopt;
+      }
+      auto const time = std::filesystem::last_write_time(filename, ec);
+      if (ec) {
+        return std::nullopt;
+      }
+      return source_stamp{uint64_t(size), int64_t(time.time_since_epoch().count())};
+    }
+
+    auto operator==(source_stamp const& other) const -> bool {
+      return size == other.size && time == other.time;
+    }
+  };
+
+  namespace detail {
+
+    constexpr auto binary_alignment = size_t{64};
+
+    struct binary_header {
+      char magic[4];
+      uint32_t byte_order; // 0x01020304 as written by the machine that wrote the file.
+      uint32_t version;
+      uint32_t input_type;
+      uint32_t output_type;
+      uint32_t delim; // Delimiter of the CSV source.
+      uint64_t nrows;
+      uint64_t ninputs;
+      uint64_t source_size;
+      int64_t source_time;
+    };
+
+    // Code of an arithmetic type in the header: its kind (unsigned, signed, floating point) and
+    // its size. Other types cannot be stored (0).
+    template<typename T>
+    constexpr auto binary_type_code() -> uint32_t {
+      if constexpr (std::is_floating_point_v<T>) {
+        return 0x300 | uint32_t(sizeof(T));
+      } else if constexpr (std::is_integral_v<T>) {
+        return (std::is_signed_v<T>? 0x200 : 0x100) | uint32_t(sizeof(T));
+      } else {
+        return 0;
+      }
+    }
+
+    inline auto align_up(size_t offset) -> size_t {
+      return (offset + binary_alignment - 1) / binary_alignment * binary_alignment;
+    }
+
+  } /* end namespace detail */
+
+  /**
+   * \brief A data_matrix stored in the binary format and mapped in memory: its columns are read
+   *        in place, without parsing nor copying (a membership_tensor fuzzifies them straight
+   *        from the file). It is also a chunk source (see is_chunk_source), copying 'chunk_rows'
+   *        rows at a time into a data_matrix.
+   */
+  template<typename Input, typename Output>
+  class mapped_dataset {
+   public:
+    using input_type = Input;
+    using output_type = Output;
+    using data_matrix_type = data_matrix<input_type, output_type>;
+
+    /**
+     * \brief Maps a binary file, or returns std::nullopt if it cannot be read, is not in the
+     *        binary format, or stores other types.
+     */
+    static auto open(char const* filename, size_t chunk_rows = size_t{1} << 16)
+        -> std::optional<mapped_dataset<input_type, output_type>>;
+
+    /**
+     * \brief Writes a data_matrix in the binary format, recording the stamp and the delimiter of
+     *        the CSV file it comes from. The file is written under a temporary name then renamed,
+     *        so that readers never see it incomplete. Returns false if the types cannot be stored
+     *        or the file cannot be written.
+     */
+    static auto write(data_matrix_type const& dm, char const* filename, source_stamp const& source = {},
+                      char delim = ',') -> bool;
+
+    /**
+     * \brief Returns the number of columns (not counting the output, like data_matrix).
+     */
+    auto ncols() const noexcept -> size_t {
+      return m_input_names.size();
+    }
+
+    /**
+     * \brief Returns the number of rows.
+     */
+    auto nrows() const noexcept -> size_t {
+      return m_nrows;
+    }
+
+    /**
+     * \brief Names of the input variables.
+     */
+    auto input_names() const noexcept -> vector<string> const& {
+      return m_input_names;
+    }
+
+    /**
+     * \brief Returns the name of the nth input variable.
+     */
+    auto input_name(size_t n) const noexcept -> string const& {
+      return m_input_names[n];
+    }
+
+    /**
+     * \brief Returns the name of the output variable.
+     */
+    auto output_name() const noexcept -> string const& {
+      return m_output_name;
+    }
+
+    /**
+     * \brief The values of the nth input variable, in the mapped file.
+     */
+    auto column(size_t n) const -> span<input_type> {
+      return span<input_type>{reinterpret_cast<input_type const*>(m_file.data() + m_column_offsets.at(n)), m_nrows};
+    }
+
+    /**
+     * \brief The outputs, in the mapped file.
+     */
+    auto outputs() const -> span<output_type> {
+      return span<output_type>{reinterpret_cast<output_type const*>(m_file.data() + m_outputs_offset), m_nrows};
+    }
+
+    /**
+     * \brief Stamp of the CSV file the data come from.
+     */
+    auto source() const noexcept -> source_stamp const& {
+      return m_source;
+    }
+
+    /**
+     * \brief Delimiter of the CSV file the data come from.
+     */
+    auto source_delim() const noexcept -> char {
+      return m_delim;
+    }
+
+    /**
+     * \brief Copies the rows [first, first + n) (clamped to the number of rows) into a
+     *        data_matrix.
+     */
+    auto to_data_matrix(size_t first = 0, size_t n = size_t(-1)) const -> data_matrix_type;
+
+    /**
+     * \brief An empty data_matrix with the headers of the dataset, to be filled by 'next'.
+     */
+    auto make_chunk() const -> data_matrix_type {
+      return data_matrix_type{m_input_names, m_output_name};
+    }
+
+    /**
+     * \brief Replaces 'chunk' by the next 'chunk_rows' rows (or less, for the last chunk).
+     *        Returns false, with an empty chunk, once all the rows have been read.
+     */
+    auto next(data_matrix_type& chunk) -> bool {
+      chunk = to_data_matrix(m_next_row, m_chunk_rows);
+      m_next_row += chunk.nrows();
+      return chunk.nrows() > 0;
+    }
+
+    /**
+     * \brief Goes back to the first row.
+     */
+    auto rewind() noexcept -> void {
+      m_next_row = 0;
+    }
+
+   private:
+    mapped_dataset(mapped_file file, size_t chunk_rows)
+      : m_file{std::move(file)}, m_chunk_rows{std::max(chunk_rows, size_t{1})} {
+    }
+
+    mapped_file m_file;
+    size_t m_chunk_rows;
+    size_t m_next_row = 0;
+    size_t m_nrows = 0;
+    vector<string> m_input_names;
+    string m_output_name;
+    vector<size_t> m_column_offsets; // Offset of each input column in the file.
+    size_t m_outputs_offset = 0;
+    source_stamp m_source;
+    char m_delim = ',';
+  };
+
+  /**
+   * \brief Name of the binary file caching a CSV file: the same name, followed by ".cjdm".
+   */
+  inline auto cached_filename(char const* filename) -> string {
+    return string{filename} + ".cjdm";
+  }
+
+  /**
+   * \brief Loads a CSV file (see data_matrix::from_file) through its binary cache: if the cache
+   *        was written from the current version of the file (same size, modification time and
+   *        delimiter), it is read without parsing. Otherwise the CSV file is parsed and the cache
+   *        is (re)written next to it, if possible.
+   */
+  template<typename Input, typename Output>
+  auto load_cached(char const* filename, char delim = ',', size_t threads = 0)
+      -> std::optional<data_matrix<Input, Output>> {
+    auto const cache = cached_filename(filename);
+    auto const stamp = source_stamp::of(filename);
+    if (!stamp) {
+      return std::nullopt;
+    }
+    if (auto const md = mapped_dataset<Input, Output>::open(cache.c_str());
+        md && md->source() == *stamp && md->source_delim() == delim) {
+      return md->to_data_matrix();
+    }
+    auto dm = data_matrix<Input, Output>::from_file(filename, delim, threads);
+    if (dm) {
+      mapped_dataset<Input, Output>::write(*dm, cache.c_str(), *stamp, delim);
+    }
+    return dm;
+  }
+
+  // Definitions:
+
+  template<typename Input, typename Output>
+  auto mapped_dataset<Input, Output>::open(char const* filename, size_t chunk_rows)
+      -> std::optional<mapped_dataset<Input, Output>> {
+    if constexpr (detail::binary_type_code<Input>() == 0 || detail::binary_type_code<Output>() == 0) {
+      return std::nullopt;
+    } else {
+      auto f = mapped_file::open(filename);
+      if (!f || f->size() < sizeof(detail::binary_header)) {
+        return std::nullopt;
+      }
+      auto h = detail::binary_header{};
+      std::memcpy(&h, f->data(), sizeof(h));
+      if (std::memcmp(h.magic, "CJDM", 4) != 0 || h.byte_order != 0x01020304 || h.version != 1
+          || h.input_type != detail::binary_type_code<Input>()
+          || h.output_type != detail::binary_type_code<Output>()) {
+        return std::nullopt;
+      }
+      if (h.nrows > f->size() || h.ninputs > f->size()) {
+        return std::nullopt;
+      }
+      auto md = mapped_dataset<Input, Output>{std::move(*f), chunk_rows};
+      auto const size = md.m_file.size();
+      auto const* const data = md.m_file.data();
+
+      // Names:
+      auto offset = sizeof(h);
+      auto names = vector<string>{};
+      for (auto n = uint64_t{0}; n <= h.ninputs; ++n) {
+        auto length = uint32_t{0};
+        if (size - offset < sizeof(length)) {
+          return std::nullopt;
+        }
+        std::memcpy(&length, data + offset, sizeof(length));
+        offset += sizeof(length);
+        if (size - offset < length) {
+          return std::nullopt;
+        }
+        names.emplace_back(data + offset, length);
+        offset += length;
+      }
+
+      // Columns:
+      offset = detail::align_up(offset);
+      for (auto n = uint64_t{0}; n < h.ninputs; ++n) {
+        md.m_column_offsets.push_back(offset);
+        offset = detail::align_up(offset + h.nrows * sizeof(Input));
+      }
+      md.m_outputs_offset = offset;
+      if (offset > size || size - offset < h.nrows * sizeof(Output)) {
+        return std::nullopt;
+      }
+
+      md.m_nrows = size_t(h.nrows);
+      md.m_output_name = names.back();
+      names.pop_back();
+      md.m_input_names = std::move(names);
+      md.m_source = source_stamp{h.source_size, h.source_time};
+      md.m_delim = char(h.delim);
+      return std::optional<mapped_dataset<Input, Output>>{std::move(md)};
+    }
+  }
+
+  template<typename Input, typename Output>
+  auto mapped_dataset<Input, Output>::write(data_matrix_type const& dm, char const* filename,
+                                            source_stamp const& source, char delim) -> bool {
+    if constexpr (detail::binary_type_code<Input>() == 0 || detail::binary_type_code<Output>() == 0) {
+      return false;
+    } else {
+      auto h = detail::binary_header{{'C', 'J', 'D', 'M'}, 0x01020304, 1, detail::binary_type_code<Input>(),
+                                     detail::binary_type_code<Output>(), uint32_t(delim), dm.nrows(),
+                                     dm.ncols(), source.size, source.time};
+      // A unique temporary name, in case several processes write the same cache:
+      auto const tmp = string{filename} + ".tmp" + std::to_string(std::random_device{}());
+      {
+        auto out = std::ofstream{tmp, std::ios::binary};
+        auto offset = size_t{0};
+        auto const put = [&](void const* p, size_t n) {
+          out.write(static_cast<char const*>(p), std::streamsize(n));
+          offset += n;
+        };
+        auto const pad = [&]() {
+          static char const zeros[detail::binary_alignment] = {};
+          put(zeros, detail::align_up(offset) - offset);
+        };
+        put(&h, sizeof(h));
+        auto names = dm.input_names();
+        names.push_back(dm.output_name());
+        for (auto const& name : names) {
+          auto const length = uint32_t(name.size());
+          put(&length, sizeof(length));
+          put(name.data(), name.size());
+        }
+        for (auto n = size_t{0}; n < dm.ncols(); ++n) {
+          pad();
+          put(dm.column(n).data(), dm.nrows() * sizeof(Input));
+        }
+        pad();
+        put(dm.outputs().data(), dm.nrows() * sizeof(Output));
+        if (!out.flush()) {
+          out.close();
+          std::remove(tmp.c_str());
+          return false;
+        }
+      }
+      auto ec = std::error_code{};
+      std::filesystem::rename(tmp, filename, ec);
+      if (ec) {
+        std::remove(tmp.c_str());
+        return false;
+      }
+      return true;
+    }
+  }
+
+  template<typename Input, typename Output>
+  auto mapped_dataset<Input, Output>::to_data_matrix(size_t first, size_t n) const -> data_matrix_type {
+    first = std::min(first, m_nrows);
+    n = std::min(n, m_nrows - first);
+    auto columns = vector<typename data_matrix_type::column_type>(ncols());
+    for (auto c = size_t{0}; c < ncols(); ++c) {
+      auto const xs = column(c);
+      columns[c].assign(xs.begin() + first, xs.begin() + first + n);
+    }
+    auto const ys = outputs();
+    return data_matrix_type{m_input_names, m_output_name, std::move(columns),
+                            vector<output_type>(ys.begin() + first, ys.begin() + first + n)};
+  }
+
+} /* end namespace cj */
+
+#endif
@@ -0,0 +1,170 @@
+/**
+ * # Summary
+ *
+ * K-fold cross-validation (repeated and stratified) of fuzzy classifiers. The folds are indices
+ * into a single dataset: their membership tensors are gathered from the dataset's tensor instead
+ * of copying and fuzzifying rows, and the folds are trained and evaluated in parallel.
+ */
+#ifndef CJ_CROSS_VALIDATION_HH_
+#define CJ_CROSS_VALIDATION_HH_
+
+#include <numeric>
+#include "cj/common.hh"
+#include "cj/math/confusion.hh"
+#include "cj/math/random.hh"
+#include "cj/logics/prepared_dataset.hh"
+#include "cj/utils/parallel.hh"
+
+namespace cj {
+
+  /**
+   * \brief The rows used for training and for testing in one fold of a cross-validation, as
+   *        sorted indices into the dataset (see data_matrix_view to use them as rows).
+   */
+  struct cv_fold {
+    size_t repeat;
+    size_t fold;
+    vector<size_t> training;
+    vector<size_t> testing;
+  };
+
+  namespace detail {
+
+    // Makes the k folds of a repeat given the test fold of every row.
+    inline auto folds_of(size_t repeat, size_t k, vector<size_t> const& fold_of) -> vector<cv_fold> {
+      auto folds = vector<cv_fold>{};
+      folds.reserve(k);
+      for (auto f = size_t{0}; f < k; ++f) {
+        folds.push_back(cv_fold{repeat, f, {}, {}});
+      }
+      for (auto r = size_t{0}; r < fold_of.size(); ++r) {
+        for (auto f = size_t{0}; f < k; ++f) {
+          (f == fold_of[r]? folds[f].testing : folds[f].training).push_back(r);
+        }
+      }
+      return folds;
+    }
+
+  } /* end namespace detail */
+
+  /**
+   * \brief Splits 'nrows' rows in 'k' folds of (nearly) equal sizes, 'repeats' times with
+   *        different shuffles. Each row is tested once per repeat.
+   *
+   * \param nrows     Number of rows of the dataset.
+   * \param k         Number of folds (at least 2, and at most 'nrows').
+   * \param repeats   Number of times the rows are shuffled and split.
+   * \param seed      Seed for the shuffles (repeat 'r' uses a stream derived from (seed, r)).
+   * \return          The k * repeats folds, ordered by repeat.
+   */
+  inline auto kfold(size_t nrows, size_t k, size_t repeats, size_t seed) -> vector<cv_fold> {
+    auto folds = vector<cv_fold>{};
+    auto order = vector<size_t>(nrows);
+    auto fold_of = vector<size_t>(nrows);
+    for (auto rep = size_t{0}; rep < repeats; ++rep) {
+      auto rng = std::mt19937_64(derive_seed(seed, rep, 0));
+      std::iota(order.begin(), order.end(), size_t{0});
+      std::shuffle(order.begin(), order.end(), rng);
+      for (auto j = size_t{0}; j < nrows; ++j) {
+        fold_of[order[j]] = j * k / nrows;
+      }
+      auto const rep_folds = detail::folds_of(rep, k, fold_of);
+      folds.insert(folds.end(), rep_folds.begin(), rep_folds.end());
+    }
+    return folds;
+  }
+
+  /**
+   * \brief Like kfold, but the rows of each output are spread evenly over the folds, so that
+   *        every fold has (nearly) the proportions of outputs of the whole dataset.
+   *
+   * \param outputs   Output of each row of the dataset.
+   */
+  template<typename Output>
+  auto stratified_kfold(vector<Output> const& outputs, size_t k, size_t repeats, size_t seed)
+      -> vector<cv_fold> {
+    auto by_output = ordered_map<Output, vector<size_t>>{};
+    for (auto r = size_t{0}; r < outputs.size(); ++r) {
+      by_output[outputs[r]].push_back(r);
+    }
+    auto folds = vector<cv_fold>{};
+    auto fold_of = vector<size_t>(outputs.size());
+    for (auto rep = size_t{0}; rep < repeats; ++rep) {
+      auto rng = std::mt19937_64(derive_seed(seed, rep, 1));
+      // The rows of each output are dealt to the folds in turn, continuing where the previous
+      // output stopped so that the folds also have (nearly) the same size:
+      auto next = size_t{0};
+      for (auto& rows : by_output) {
+        auto shuffled = rows.second;
+        std::shuffle(shuffled.begin(), shuffled.end(), rng);
+        for (auto const r : shuffled) {
+          fold_of[r] = next;
+          next = (next + 1) % k;
+        }
+      }
+      auto const rep_folds = detail::folds_of(rep, k, fold_of);
+      folds.insert(folds.end(), rep_folds.begin(), rep_folds.end());
+    }
+    return folds;
+  }
+
+  /**
+   * \brief Results of a cross-validation.
+   */
+  struct cv_results {
+    confusion<size_t, double> pooled; // Sum of the confusion matrices of the folds.
+    vector<confusion<size_t, double>> folds; // Confusion matrix of each fold (on its testing rows).
+    vector<double> tss; // True skill statistic of each fold.
+    double mean_tss;
+    double sd_tss; // Sample standard deviation of the TSS over the folds.
+  };
+
+  /**
+   * \brief Trains a classifier on the training rows of each fold and evaluates it on the testing
+   *        rows. The membership tensors of the folds are gathered from the dataset's tensor, and
+   *        the folds are processed on 'threads' threads.
+   *
+   * \param ds          Dataset.
+   * \param folds       Folds (e.g. from kfold or stratified_kfold).
+   * \param train       Builds a classifier given the membership tensor of the training rows and the
+   *                    fold ((membership_tensor_type const&, cv_fold const&) -> Classifier). It must
+   *                    be safe to call concurrently, and use the interpretation of the dataset.
+   * \param threads     Number of folds processed at the same time.
+   * \param positive    Category used to compute the TSS.
+   */
+  template<typename Classifier, typename Train>
+  auto cross_validate(prepared_dataset<Classifier> const& ds, vector<cv_fold> const& folds,
+                      Train const& train, size_t threads = 1, size_t positive = 1) -> cv_results {
+    using membership_tensor_type = typename Classifier::membership_tensor_type;
+
+    auto const ncats = ds.interpretation()->num_categories();
+    auto results = cv_results{confusion<size_t, double>{ncats},
+                              vector<confusion<size_t, double>>(folds.size(), confusion<size_t, double>{ncats}),
+                              vector<double>(folds.size(), 0.0), 0.0, 0.0};
+    parallel_for(folds.size(), threads, [&](size_t f) {
+      auto const training = membership_tensor_type{ds.memberships(), folds[f].training};
+      auto const testing = membership_tensor_type{ds.memberships(), folds[f].testing};
+      Classifier const c = train(training, folds[f]);
+      results.folds[f] = c.evaluate_all(testing);
+      results.tss[f] = results.folds[f].tss(positive);
+    });
+
+    for (auto const& fc : results.folds) {
+      results.pooled += fc;
+    }
+    if (!folds.empty()) {
+      results.mean_tss = std::accumulate(results.tss.begin(), results.tss.end(), 0.0) / folds.size();
+    }
+    if (folds.size() > 1) {
+      auto ss = 0.0;
+      for (auto const t : results.tss) {
+        ss += (t - results.mean_tss) * (t - results.mean_tss);
+      }
+      results.sd_tss = std::sqrt(ss / (folds.size() - 1));
+    }
+    return results;
+  }
+
+} /* end namespace cj */
+
+#endif
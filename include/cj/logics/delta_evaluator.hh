@@ -0,0 +1,313 @@
+/**
+ * # Summary
+ *
+ * Incremental evaluation of a fuzzy classifier on a membership tensor: the activation of every
+ * rule and the aggregate of every class are cached so that, after a mutation adding or removing a
+ * few rules, only the changed rules and the aggregates of their classes are recomputed.
+ */
+#ifndef CJ_DELTA_EVALUATOR_HH_
+#define CJ_DELTA_EVALUATOR_HH_
+
+#include "cj/common.hh"
+#include "cj/math/truth.hh"
+#include "cj/math/truth_kernels.hh"
+#include "cj/math/confusion.hh"
+#include "cj/logics/membership_tensor.hh"
+
+namespace cj {
+
+  namespace detail {
+
+    template<typename Truth>
+    struct is_godel : std::false_type {};
+
+    template<typename F>
+    struct is_godel<godel<F>> : std::true_type {};
+
+  } /* end namespace detail */
+
+  /**
+   * \brief Caches the per-rule activations and per-class aggregates of a classifier for a
+   *        membership tensor, and updates them (along with the predictions and the confusion
+   *        matrix) when the classifier's rules change.
+   *
+   * The aggregates of the Gödel-Dummett s-norm (max) are updated in place, keeping the two
+   * highest activations of each class for each row so that removing a rule rarely requires going
+   * back to the other rules. For the other logics, the aggregates of the classes with changed rules
+   * are rebuilt from the cached activations, in the order of the rules, so the results are
+   * identical to fuzzy_classifier::evaluate_all.
+   *
+   * The tensor must outlive the evaluator.
+   */
+  template<typename Classifier>
+  class delta_evaluator {
+   public:
+    using classifier_type = Classifier;
+    using truth_type = typename classifier_type::truth_type;
+    using id_type = typename classifier_type::id_type;
+    using antecedent_type = typename classifier_type::antecedent_type;
+    using rules_type = typename classifier_type::rules_type;
+    using membership_tensor_type = typename classifier_type::membership_tensor_type;
+
+    /**
+     * \brief Evaluates a classifier on a membership tensor, caching the activations.
+     */
+    delta_evaluator(classifier_type const& c, membership_tensor_type const& mt);
+
+    /**
+     * \brief Brings the cache up-to-date with the rules of 'c' (which must share the
+     *        interpretation of the classifier used to build the evaluator) and returns the
+     *        updated confusion matrix.
+     */
+    auto update(classifier_type const& c) -> confusion<size_t, double> const&;
+
+    /**
+     * \brief Confusion matrix of the last evaluated classifier.
+     */
+    auto results() const -> confusion<size_t, double> const& {
+      return m_results;
+    }
+
+    /**
+     * \brief Predicted category for each row of the tensor.
+     */
+    auto predictions() const -> vector<id_type> const& {
+      return m_predictions;
+    }
+
+    /**
+     * \brief Number of cached rules.
+     */
+    auto size() const -> size_t {
+      return m_rules.size();
+    }
+
+   private:
+    using activation_type = vector<truth_type>;
+    static constexpr bool is_godel = detail::is_godel<truth_type>::value;
+
+    /**
+     * \brief Activation of an antecedent for each row of the tensor.
+     */
+    auto activation(antecedent_type const& a) const -> activation_type;
+
+    /**
+     * \brief Adds a rule to the cache and its activations to the aggregates.
+     */
+    auto add(antecedent_type const& a, id_type c) -> void;
+
+    /**
+     * \brief Removes a rule from the cache and its activations from the aggregates. Returns the
+     *        iterator following the removed rule.
+     */
+    auto remove(typename flat_map<antecedent_type, pair<id_type, activation_type>>::iterator it)
+      -> typename flat_map<antecedent_type, pair<id_type, activation_type>>::iterator;
+
+    /**
+     * \brief Rebuilds the aggregates of class 'c' from the cached activations.
+     */
+    auto rebuild(id_type c) -> void;
+
+    /**
+     * \brief Rebuilds the aggregates of class 'c' for a single row (Gödel-Dummett only).
+     */
+    auto rebuild(id_type c, size_t row) -> void;
+
+    /**
+     * \brief Sets the aggregate of class 'c' for a row, flagging the row if it changed.
+     */
+    auto set_aggregate(id_type c, size_t row, truth_type t) -> void {
+      if (m_top1[c][row] != t) {
+        m_top1[c][row] = t;
+        m_dirty[row] = true;
+      }
+    }
+
+    /**
+     * \brief Recomputes the predictions of the flagged rows and updates the confusion matrix.
+     */
+    auto predict() -> void;
+
+    membership_tensor_type const* m_mt;
+    flat_map<antecedent_type, pair<id_type, activation_type>> m_rules; // Cached activations.
+    vector<activation_type> m_top1; // Aggregate of each class for each row.
+    vector<activation_type> m_top2; // Second highest activation (Gödel-Dummett only).
+    vector<vector<uint32_t>> m_count1; // Number of rules reaching 'm_top1' (Gödel-Dummett only).
+    vector<bool> m_dirty; // Rows whose aggregates changed since the last prediction.
+    vector<bool> m_rebuild; // Classes to rebuild (all logics but Gödel-Dummett).
+    vector<id_type> m_predictions;
+    confusion<size_t, double> m_results;
+  };
+
+  template<typename C>
+  delta_evaluator<C>::delta_evaluator(classifier_type const& c, membership_tensor_type const& mt)
+    : m_mt{&mt},
+      m_top1(c.get_raw_interpretation_ptr()->num_categories(),
+             activation_type(mt.nrows(), truth_type{0})),
+      m_dirty(mt.nrows(), true),
+      m_rebuild(c.get_raw_interpretation_ptr()->num_categories(), false),
+      m_predictions(mt.nrows(), id_type{0}),
+      m_results{c.get_raw_interpretation_ptr()->num_categories()} {
+    if constexpr (is_godel) {
+      m_top2 = m_top1;
+      m_count1.assign(m_top1.size(), vector<uint32_t>(mt.nrows(), 0));
+    }
+    for (auto r = size_t{0}; r < mt.nrows(); ++r) {
+      m_results.add_count(0, mt.output(r));
+    }
+    update(c);
+  }
+
+  template<typename C>
+  auto delta_evaluator<C>::update(classifier_type const& c) -> confusion<size_t, double> const& {
+    // Walks the two sorted sets of rules to find the removed and added ones:
+    auto const& rules = c.rules();
+    auto added = vector<typename rules_type::value_type const*>{};
+    auto old_it = m_rules.begin();
+    auto new_it = rules.begin();
+    while (old_it != m_rules.end() || new_it != rules.end()) {
+      if (new_it == rules.end() || (old_it != m_rules.end() && old_it->first < new_it->first)) {
+        old_it = remove(old_it);
+      } else if (old_it == m_rules.end() || new_it->first < old_it->first) {
+        added.push_back(&*new_it++);
+      } else {
+        if (old_it->second.first != new_it->second) {
+          old_it = remove(old_it);
+          added.push_back(&*new_it);
+        } else {
+          ++old_it;
+        }
+        ++new_it;
+      }
+    }
+    for (auto const r : added) {
+      add(r->first, r->second);
+    }
+    for (auto k = size_t{0}; k < m_rebuild.size(); ++k) {
+      if (m_rebuild[k]) {
+        rebuild(id_type(k));
+        m_rebuild[k] = false;
+      }
+    }
+    predict();
+    return m_results;
+  }
+
+  template<typename C>
+  auto delta_evaluator<C>::activation(antecedent_type const& a) const -> activation_type {
+    auto const nrows = m_mt->nrows();
+    auto act = activation_type(nrows, truth_type{1});
+    for (auto const& v : a) {
+      conjoin(act.data(), m_mt->column(m_mt->column_index(v.first, v.second)), act.data(), nrows);
+    }
+    return act;
+  }
+
+  template<typename C>
+  auto delta_evaluator<C>::add(antecedent_type const& a, id_type c) -> void {
+    auto const it = m_rules.emplace(a, pair<id_type, activation_type>{c, activation(a)}).first;
+    if constexpr (is_godel) {
+      auto const& act = it->second.second;
+      for (auto r = size_t{0}; r < act.size(); ++r) {
+        if (m_top1[c][r] < act[r]) {
+          m_top2[c][r] = m_top1[c][r];
+          m_count1[c][r] = 1;
+          set_aggregate(c, r, act[r]);
+        } else if (act[r] == m_top1[c][r]) {
+          ++m_count1[c][r];
+        } else if (m_top2[c][r] < act[r]) {
+          m_top2[c][r] = act[r];
+        }
+      }
+    } else {
+      m_rebuild[c] = true;
+    }
+  }
+
+  template<typename C>
+  auto delta_evaluator<C>::remove(
+      typename flat_map<antecedent_type, pair<id_type, activation_type>>::iterator it)
+      -> typename flat_map<antecedent_type, pair<id_type, activation_type>>::iterator {
+    auto const c = it->second.first;
+    if constexpr (is_godel) {
+      auto const act = std::move(it->second.second);
+      auto const idx = std::distance(m_rules.begin(), it);
+      m_rules.erase(it);
+      for (auto r = size_t{0}; r < act.size(); ++r) {
+        if (act[r] == truth_type{0} || act[r] < m_top2[c][r]) {
+          continue; // Neither the highest nor the second highest activation changed.
+        }
+        if (act[r] == m_top1[c][r] && m_count1[c][r] > 1) {
+          --m_count1[c][r];
+        } else {
+          rebuild(c, r);
+        }
+      }
+      return m_rules.begin() + idx;
+    }
+    m_rebuild[c] = true;
+    return m_rules.erase(it);
+  }
+
+  template<typename C>
+  auto delta_evaluator<C>::rebuild(id_type c) -> void {
+    auto const nrows = m_mt->nrows();
+    auto agg = activation_type(nrows, truth_type{0});
+    for (auto const& rule : m_rules) {
+      if (rule.second.first == c) {
+        disjoin(agg.data(), rule.second.second.data(), agg.data(), nrows);
+      }
+    }
+    for (auto r = size_t{0}; r < nrows; ++r) {
+      set_aggregate(c, r, agg[r]);
+    }
+  }
+
+  template<typename C>
+  auto delta_evaluator<C>::rebuild(id_type c, size_t row) -> void {
+    auto top1 = truth_type{0}, top2 = truth_type{0};
+    auto count1 = uint32_t{0};
+    for (auto const& rule : m_rules) {
+      if (rule.second.first == c) {
+        auto const a = rule.second.second[row];
+        if (top1 < a) {
+          top2 = top1;
+          top1 = a;
+          count1 = 1;
+        } else if (a == top1) {
+          ++count1;
+        } else if (top2 < a) {
+          top2 = a;
+        }
+      }
+    }
+    m_top2[c][row] = top2;
+    m_count1[c][row] = count1;
+    set_aggregate(c, row, top1);
+  }
+
+  template<typename C>
+  auto delta_evaluator<C>::predict() -> void {
+    auto const ncats = m_top1.size();
+    for (auto r = size_t{0}; r < m_dirty.size(); ++r) {
+      if (m_dirty[r]) {
+        // Same tie-breaking as idx_of_maximum: the first class with the highest truth wins.
+        auto best = size_t{0};
+        for (auto k = size_t{1}; k < ncats; ++k) {
+          if (m_top1[best][r] < m_top1[k][r]) {
+            best = k;
+          }
+        }
+        if (best != m_predictions[r]) {
+          m_results.sub_count(m_predictions[r], m_mt->output(r));
+          m_results.add_count(best, m_mt->output(r));
+          m_predictions[r] = id_type(best);
+        }
+        m_dirty[r] = false;
+      }
+    }
+  }
+
+} /* end namespace cj */
+
+#endif
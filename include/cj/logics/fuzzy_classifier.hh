@@ -6,17 +6,33 @@
 #ifndef CJ_FUZZY_CLASSIFIER_HH_
 #define CJ_FUZZY_CLASSIFIER_HH_
 
+#include <numeric>
 #include "cj/common.hh"
 #include "cj/math/fuzzy_partition.hh"
 #include "cj/math/truth.hh"
+#include "cj/math/truth_kernels.hh"
 #include "cj/math/confusion.hh"
 #include "cj/math/statistics.hh"
 #include "cj/data/data_matrix.hh"
+#include "cj/data/data_matrix_view.hh"
+#include "cj/data/csv_chunk_reader.hh"
+#include "cj/logics/membership_tensor.hh"
 #include "cj/utils/top_n_map.hh"
+#include "cj/utils/lru_cache.hh"
+#include "cj/utils/parallel.hh"
+#include "cj/math/random.hh"
 #include "cj/math/set.hh"
 
 namespace cj {
 
+  /**
+   * \brief How islands exchange their best classifiers in fuzzy_classifier::evolve_islands.
+   */
+  enum class migration_topology {
+    ring, // Island 'i' receives the migrants of island 'i - 1'.
+    fully_connected // Every island receives the migrants of all the others.
+  };
+
   /**
    * \brief Fuzzy rule-based classifier: predict a category given a set of inputs using a set
    *        of fuzzy rules of the form 'IF antecedents THEN category'.
@@ -33,11 +49,57 @@ namespace cj {
     using interpretation_ptr = std::shared_ptr<interpretation>;
     using mutate_function = std::function<void(self_type&, std::mt19937_64&)>;
     using fitness_function = std::function<double(self_type const&, data_matrix<input_type, id_type> const&)>;
+    using membership_tensor_type = membership_tensor<truth_type, id_type>;
+    using tensor_fitness_function = std::function<double(self_type const&, membership_tensor_type const&)>;
     using antecedent_type = flat_map<id_type, id_type>; // Maps an input ID to a fuzzyset ID.
     using rule_type = pair<antecedent_type, id_type>; // Pairs a rule with its output (for now: a binary value).
     using rules_type = flat_map<antecedent_type, id_type>; // Maps rules to output.
     using const_iterator = typename rules_type::const_iterator;
     using operator_type = std::function<truth_type(truth_type const&, truth_type const&)>;
+    using membership_function = std::function<truth_type(input_type)>;
+    using fuzzy_set_type = fuzzy_set<input_type, truth_type>;
+
+    /**
+     * \brief Contiguous (structure-of-arrays) form of the rules used for evaluation. The literals
+     *        of all rules are stored back-to-back, the literals of rule 'r' being in the range
+     *        [offsets[r], offsets[r + 1]). Rules are sorted by class.
+     *
+     *        The antecedents of each class are also arranged as a prefix trie, stored in
+     *        depth-first order: the conjunction of a shared prefix is computed once for all the
+     *        rules below it, and the subtree of node 'k' is the range [k, trie_ends[k]).
+     */
+    struct compiled_rules {
+      vector<id_type> inputs; // Input ID of each literal.
+      vector<id_type> sets; // Fuzzy set ID of each literal.
+      vector<fuzzy_set_type const*> memberships; // Fuzzy set of each literal.
+      vector<size_t> columns; // Column of each literal in a membership_tensor.
+      vector<size_t> offsets; // Where the literals of each rule begin (size: number of rules + 1).
+      vector<id_type> classes; // Output of each rule.
+      vector<id_type> used_inputs; // Inputs appearing in the rules (sorted).
+      size_t min_row_size = 0; // Rows must have at least this many inputs.
+      vector<size_t> trie_columns; // Column of the literal of each node.
+      vector<size_t> trie_depths; // Depth of each node (1 for the first literal of antecedents).
+      vector<size_t> trie_ends; // One past the last node of the subtree of each node.
+      vector<unsigned char> trie_terminal; // Whether a rule ends at each node.
+      vector<id_type> trie_classes; // Class of each node (the tries are sorted by class).
+      size_t trie_depth = 0; // Depth of the deepest node.
+    };
+
+    /**
+     * \brief Inverted index from the literals to the rules that use them. Rules are stored in
+     *        slots (reused once freed) so that the posting lists stay valid as rules come and go.
+     */
+    struct rule_index {
+      vector<vector<vector<size_t>>> postings; // Slots of the rules using each (input, set).
+      vector<size_t> nliterals; // Number of literals of each input in the rules.
+      vector<rule_type> slots; // Rule of each slot (empty antecedent: free slot).
+      vector<size_t> free_slots;
+    };
+
+    /**
+     * \brief Rule bases of at least this many rules maintain a rule_index, used to evaluate rows.
+     */
+    static constexpr size_t index_min_rules = 128;
 
     /**
      * \brief Builds a fuzzy knowledge base with a pointer to fuzzy_set and (optionally) a set of
@@ -103,14 +165,41 @@ namespace cj {
      * \brief Removes a rule (unless it is already there).
      */
     auto rmv_rule(antecedent_type const& a) -> void {
-      m_rules.erase(a);
+      auto it = m_rules.find(a);
+      if (it != m_rules.end()) {
+        m_hash ^= rule_hash(it->first, it->second);
+        if (m_indexed) {
+          index_erase(it->first);
+        }
+        m_rules.erase(it);
+        m_stale = true;
+      }
     }
 
     /**
      * \brief Removes a rule (if present).
      */
     auto rmv_rule(rule_type const& r) -> void {
-      m_rules.erase(r.first);
+      rmv_rule(r.first);
+    }
+
+    /**
+     * \brief Zobrist-style hash of the rules: the exclusive or of the hashes of the rules, updated
+     *        in O(1) (with respect to the number of rules) when rules are added or removed.
+     */
+    auto hash() const -> size_t {
+      return m_hash;
+    }
+
+    /**
+     * \brief Hash of a single rule, as used by hash().
+     */
+    static auto rule_hash(antecedent_type const& a, id_type c) -> size_t {
+      auto h = splitmix64(uint64_t(c) ^ 0x2545f4914f6cdd1dULL);
+      for (auto const& v : a) {
+        h ^= splitmix64((uint64_t(v.first) << 32) | uint64_t(v.second));
+      }
+      return splitmix64(h);
     }
 
     /**
@@ -137,15 +226,103 @@ namespace cj {
       return m_i.get();
     }
 
+    /**
+     * \brief Builds the contiguous form of the rules used by 'evaluate' and 'evaluate_all'. It
+     *        should be called once the rules are done mutating: evaluating a classifier with
+     *        stale compiled rules will compile them in a temporary for each call.
+     */
+    auto compile() -> void {
+      m_compiled = make_compiled();
+      m_stale = false;
+    }
+
+    /**
+     * \brief Whether the compiled rules are up-to-date with the rules.
+     */
+    auto is_compiled() const -> bool {
+      return !m_stale;
+    }
+
+    /**
+     * \brief Whether the rules are indexed (see rule_index), which happens once the rule base
+     *        reaches 'index_min_rules' rules.
+     */
+    auto is_indexed() const -> bool {
+      return m_indexed;
+    }
+
     /**
      * \brief Generates a prediction (category ID) given a set of input values.
      */
-    auto evaluate(vector<input_type> const& row) const -> id_type;
+    auto evaluate(vector<input_type> const& row) const -> id_type {
+      return evaluate_row(row);
+    }
+
+    /**
+     * \brief Generates a prediction (category ID) for the inputs of a row of a data_matrix.
+     */
+    auto evaluate(typename data_matrix<input_type, id_type>::row_inputs const& row) const -> id_type {
+      return evaluate_row(row);
+    }
+
+    /**
+     * \brief Generates a prediction (category ID) for a row of a membership tensor.
+     */
+    auto evaluate(membership_tensor_type const& mt, size_t row) const -> id_type;
 
     /**
      * \brief Returns the confusion matrix for a database of (input, category) pairs.
      */
-    auto evaluate_all(data_matrix<input_type, id_type> const& dm) const -> confusion<size_t, double>;
+    auto evaluate_all(data_matrix<input_type, id_type> const& dm) const -> confusion<size_t, double> {
+      return evaluate_rows(dm);
+    }
+
+    /**
+     * \brief Returns the confusion matrix for the rows of a view (e.g. a split or a sample of a
+     *        data_matrix).
+     */
+    auto evaluate_all(data_matrix_view<input_type, id_type> const& v) const -> confusion<size_t, double> {
+      return evaluate_rows(v);
+    }
+
+    /**
+     * \brief Returns the confusion matrix for a membership tensor built with this classifier's
+     *        interpretation.
+     */
+    auto evaluate_all(membership_tensor_type const& mt) const -> confusion<size_t, double>;
+
+    /**
+     * \brief Returns the confusion matrix for all the rows of a chunk source (e.g. a
+     *        csv_chunk_reader), which is rewound first. The chunks are fuzzified and evaluated one
+     *        at a time, so the memory used is bounded by the size of a chunk whatever the size of
+     *        the dataset (a fitness function can thus score the classifiers on such a source).
+     *        The classifier should be compiled, or its rules are compiled again for each chunk.
+     */
+    template<typename Source, typename = std::enable_if_t<is_chunk_source_v<Source>>>
+    auto evaluate_all(Source& source) const -> confusion<size_t, double> {
+      auto results = confusion<size_t, double>{m_i->num_categories()};
+      auto chunk = source.make_chunk();
+      source.rewind();
+      while (source.next(chunk)) {
+        results += evaluate_all(fuzzify(chunk));
+      }
+      return results;
+    }
+
+    /**
+     * \brief Computes the membership tensor of a database with this classifier's interpretation.
+     */
+    auto fuzzify(data_matrix<input_type, id_type> const& dm) const -> membership_tensor_type {
+      return membership_tensor_type{dm, *m_i};
+    }
+
+    /**
+     * \brief Computes the membership tensor of the rows of a view with this classifier's
+     *        interpretation.
+     */
+    auto fuzzify(data_matrix_view<input_type, id_type> const& v) const -> membership_tensor_type {
+      return membership_tensor_type{v, *m_i};
+    }
 
     /**
      * \brief Returns iterator to the beginning of the rules.
@@ -202,21 +379,195 @@ namespace cj {
      *                    Binomial with 'n' trials.
      * \param pr          The number of mutations for each classifier for each generation is a
      *                    Binomial with 'pr' probability.
+     * \param cache_size  Maximum number of fitnesses memoized by rule base, so that identical
+     *                    classifiers are not scored twice (0 to disable).
+     * \param threads     Number of threads used to mutate, mate, and evaluate the population
+     *                    ('mut' and 'fit' must then be safe to call concurrently). Each classifier
+     *                    uses its own random stream derived from (seed, generation, index), so
+     *                    the result does not depend on the number of threads.
      * \return            Best classifier
      */
     static auto evolve(self_type initial, mutate_function const& mut, fitness_function const& fit,
       std::function<bool(double)> const& stop,
       data_matrix<input_type, id_type> const& training, size_t const pop_size = 1000,
       size_t const elites = 50, size_t const t_max = 1000, size_t const seed = 42,
-      size_t const n = 100, double const pr = 0.02) -> self_type;
+      size_t const n = 100, double const pr = 0.02, size_t const cache_size = 10000,
+      size_t const threads = 1) -> self_type;
+
+    /**
+     * \brief Evolves a classifier given the membership tensor of the training data points, which
+     *        is computed once instead of once per evaluation. See the other overload for the
+     *        parameters.
+     */
+    static auto evolve(self_type initial, mutate_function const& mut,
+      tensor_fitness_function const& fit, std::function<bool(double)> const& stop,
+      membership_tensor_type const& training, size_t const pop_size = 1000,
+      size_t const elites = 50, size_t const t_max = 1000, size_t const seed = 42,
+      size_t const n = 100, double const pr = 0.02, size_t const cache_size = 10000,
+      size_t const threads = 1) -> self_type;
+
+    /**
+     * \brief Island-model evolution: evolves several populations on separate threads, with no
+     *        shared state, and exchanges their best classifiers every 'interval' generations.
+     *        The result does not depend on thread scheduling. See 'evolve' for the parameters
+     *        not listed here ('pop_size' and 'elites' are per island).
+     *
+     * \param islands     Number of populations (and threads).
+     * \param interval    Number of generations between migrations.
+     * \param migrants    Number of classifiers sent by an island at each migration (at most
+     *                    'elites'). They replace the least fit classifiers of the receiving
+     *                    islands.
+     * \param topology    Which islands receive the migrants.
+     * \return            Best classifier of all islands.
+     */
+    static auto evolve_islands(self_type initial, mutate_function const& mut,
+      tensor_fitness_function const& fit, std::function<bool(double)> const& stop,
+      membership_tensor_type const& training, size_t const islands, size_t const interval = 10,
+      size_t const migrants = 5, migration_topology const topology = migration_topology::ring,
+      size_t const pop_size = 1000, size_t const elites = 50, size_t const t_max = 1000,
+      size_t const seed = 42, size_t const n = 100, double const pr = 0.02,
+      size_t const cache_size = 10000) -> self_type;
 
    private:
+    template<typename Fitness, typename Training>
+    class population;
+
+    /**
+     * \brief Number of rows evaluated together by 'evaluate_all' on membership tensors.
+     */
+    static constexpr size_t block_rows = 256;
+
+    /**
+     * \brief Whether a class reaching the unit can stop the evaluation of its row.
+     */
+    static constexpr bool unit_absorbs = truth_trait<truth_type>::unit_absorbs;
+
+    /**
+     * \brief Whether rules and literals can be reordered without changing the results.
+     */
+    static constexpr bool order_independent = truth_trait<truth_type>::order_independent;
+
+    /**
+     * \brief Expected fraction of the rows for which a literal is not zero (a fuzzy set of a
+     *        partition of 'n' sets overlaps about 2 / n of the domain).
+     */
+    auto selectivity(id_type input) const -> double {
+      return std::min(1.0, 2.0 / double(std::max(m_i->num_partitions(input), size_t{1})));
+    }
+
+    /**
+     * \brief Builds the contiguous form of the current rules.
+     */
+    auto make_compiled() const -> compiled_rules;
+
+    /**
+     * \brief Scratch buffers to evaluate rows of inputs.
+     */
+    struct row_buffers {
+      row_buffers(size_t ncats, vector<size_t> first_columns, size_t nslots)
+        : by_classes(ncats, truth_type{0}), first_columns{std::move(first_columns)},
+          degrees(this->first_columns.back(), truth_type{0}),
+          stamps(this->first_columns.back(), 0), slot_stamps(nslots, 0), slot_hits(nslots, 0) {
+      }
+
+      vector<truth_type> by_classes; // Aggregate of each class.
+      vector<size_t> first_columns; // Column of the first fuzzy set of each input (and the total).
+      vector<truth_type> degrees; // Degree of each column (valid if its stamp is the row's).
+      vector<size_t> stamps; // Last row for which each column was active.
+      size_t stamp = 0; // Current row.
+      vector<pair<id_type, truth_type>> active; // Active fuzzy sets of an input.
+      vector<size_t> slot_stamps; // Last row for which each slot of the rule_index had a hit.
+      vector<size_t> slot_hits; // Number of active literals of each slot.
+      vector<size_t> matched; // Slots with all their literals active.
+    };
+
+    /**
+     * \brief Scratch buffers sized for the interpretation.
+     */
+    auto make_row_buffers() const -> row_buffers {
+      auto first_columns = vector<size_t>{0};
+      for (auto n = size_t{0}; n < m_i->num_input(); ++n) {
+        first_columns.push_back(first_columns.back() + m_i->num_partitions(n));
+      }
+      return row_buffers{m_i->num_categories(), std::move(first_columns), m_index.slots.size()};
+    }
+
+    /**
+     * \brief Evaluates a row with compiled rules. Only the active fuzzy sets of the row's inputs
+     *        are evaluated, and the rules with an inactive literal are skipped.
+     */
+    template<typename Row>
+    auto evaluate(compiled_rules const& cr, Row const& row, row_buffers& buf) const -> id_type;
+
+    /**
+     * \brief Evaluates a row with the rule index: the posting lists of the active fuzzy sets give
+     *        the rules whose literals are all active, and only these are evaluated.
+     */
+    template<typename Row>
+    auto evaluate_indexed(Row const& row, row_buffers& buf) const -> id_type;
+
+    /**
+     * \brief Evaluates a row given as any sequence of inputs indexed by input ID.
+     */
+    template<typename Row>
+    auto evaluate_row(Row const& row) const -> id_type;
+
+    /**
+     * \brief Returns the confusion matrix for a range of (inputs, category) rows.
+     */
+    template<typename Rows>
+    auto evaluate_rows(Rows const& rows) const -> confusion<size_t, double>;
+
+    /**
+     * \brief Indexes all the rules.
+     */
+    auto build_index() -> void;
+
+    /**
+     * \brief Adds a rule to the index.
+     */
+    auto index_insert(antecedent_type const& a, id_type c) -> void;
+
+    /**
+     * \brief Slot of a rule in the index (found with the posting list of its first literal).
+     */
+    auto index_find(antecedent_type const& a) const -> size_t;
+
+    /**
+     * \brief Removes a rule from the index.
+     */
+    auto index_erase(antecedent_type const& a) -> void;
+
+    /**
+     * \brief Evaluates a row of a membership tensor with compiled rules, using 'truth_by_classes'
+     *        as a scratch buffer.
+     */
+    auto evaluate(compiled_rules const& cr, membership_tensor_type const& mt, size_t row,
+                  vector<truth_type>& truth_by_classes) const -> id_type;
+
+    /**
+     * \brief Evolution loop shared by both overloads of 'evolve'.
+     */
+    template<typename Fitness, typename Training>
+    static auto evolve_impl(self_type initial, mutate_function const& mut, Fitness const& fit,
+      std::function<bool(double)> const& stop, Training const& training, size_t const pop_size,
+      size_t const elites, size_t const t_max, size_t const seed, size_t const n, double const pr,
+      size_t const cache_size, size_t const threads) -> self_type;
+
     rules_type m_rules;
     interpretation_ptr m_i;
+    compiled_rules m_compiled;
+    bool m_stale = true; // Whether 'm_compiled' is out-of-date.
+    size_t m_hash = 0; // Exclusive or of the hashes of the rules.
+    rule_index m_index;
+    bool m_indexed = false; // Whether 'm_index' is maintained.
 
    public:
     class interpretation {
      public:
+      using input_type = Input;
+      using truth_type = Truth;
+
       /**
        * \brief Builds an interpretation with a vector of categories.
        */
@@ -231,6 +582,29 @@ namespace cj {
        */
       auto add_triangular_partition(string const& name, size_t nsets, input_type a, input_type b) -> void;
 
+      /**
+       * \brief Adds an input variable with any fuzzy sets (e.g. from make_trapezoids,
+       *        make_gaussians, make_intervals, or wrapped functions).
+       * \param name            Name of the input variable.
+       * \param sets            Fuzzy sets of the partition.
+       * \param partition_name  Description of the partition (see partition_name).
+       * \param labels          One label per fuzzy set (default: make_labels).
+       */
+      auto add_partition(string const& name, vector<fuzzy_set_type> sets,
+                         string const& partition_name, vector<string> labels = {}) -> void;
+
+      /**
+       * \brief Makes the next add_*_partition calls sample their fuzzy sets into lookup tables of
+       *        2^k entries over [a, b] (see fuzzy_set::tabulate for the error bound), k = 0 turning
+       *        it off. Meant for normalized inputs, which should then lie in [a, b].
+       */
+      auto use_lookup_tables(size_t k, input_type a = input_type(0), input_type b = input_type(1))
+          -> void {
+        m_lut_bits = k;
+        m_lut_begin = a;
+        m_lut_end = b;
+      }
+
       /**
        * \brief Number of input variables.
        */
@@ -291,14 +665,14 @@ namespace cj {
       /**
        * \brief Returns a reference to the fuzzy sets associated with the nth input variable.
        */
-      auto get(id_type n) const -> vector<std::function<truth_type(input_type)>> const& {
+      auto get(id_type n) const -> vector<fuzzy_set_type> const& {
         return m_partitions.at(n);
       }
 
       /**
        * \brief Returns a reference to the fuzzy sets 's' associated with the nth input variable.
        */
-      auto get(id_type n, id_type s) const -> std::function<truth_type(input_type)> const& {
+      auto get(id_type n, id_type s) const -> fuzzy_set_type const& {
         return m_partitions.at(n).at(s);
       }
 
@@ -309,17 +683,35 @@ namespace cj {
         return m_partitions.at(n).at(s)(x);
       }
 
+      /**
+       * \brief Appends to 'out' the fuzzy sets of the nth input variable that are not zero for
+       *        'x', with their degrees, by increasing set ID. For the uniform triangular partitions
+       *        (at most two sets are active) this takes constant time.
+       */
+      auto active_sets(id_type n, input_type x, vector<pair<id_type, truth_type>>& out) const
+        -> void;
+
       /**
        * \brief Shows a summary of the input and output variables.
        */
       auto summary(std::ostream& os) -> std::ostream&;
 
      private:
+      /**
+       * \brief Samples the fuzzy sets into lookup tables if use_lookup_tables is on, and returns
+       *        the suffix for the name of the partition.
+       */
+      auto tabulate(vector<fuzzy_set_type>& sets) const -> string;
+
       vector<string> m_input_names; // Names of the variables (for the antecedants) given their id.
       vector<vector<string>> m_labels; // Name of the linguistic variables for each input variable.
-      vector<vector<std::function<truth_type(input_type)>>> m_partitions; // Partition for each variable.
+      vector<vector<fuzzy_set_type>> m_partitions; // Partition for each variable.
       vector<string> m_partition_names; // Name of the partitions (e.g.: Triangle blah blah, Gaussian, ...).
       vector<string> m_categories; // Name of the categories (output).
+      vector<pair<input_type, input_type>> m_grids; // (Begin, step) of uniform triangular partitions (step: 0 for the others).
+      size_t m_lut_bits = 0; // Lookup tables of 2^m_lut_bits entries (0: no lookup tables).
+      input_type m_lut_begin = input_type(0);
+      input_type m_lut_end = input_type(1);
     };
   };
 
@@ -330,12 +722,34 @@ namespace cj {
     if (it != m_rules.end()) {
       m_rules.erase(it);
     }
+    for (auto const& r : m_rules) {
+      m_hash ^= rule_hash(r.first, r.second);
+    }
+    if (m_rules.size() >= index_min_rules) {
+      build_index();
+    }
   }
 
   template<typename Truth, typename Input, typename Id>
   auto fuzzy_classifier<Truth, Input, Id>::add_rule(antecedent_type const& a, id_type c) -> bool {
     if (!a.empty()) {
-      m_rules[a] = c;
+      auto const [it, inserted] = m_rules.try_emplace(a, c);
+      if (inserted) {
+        m_hash ^= rule_hash(a, c);
+        m_stale = true;
+        if (m_indexed) {
+          index_insert(a, c);
+        } else if (m_rules.size() >= index_min_rules) {
+          build_index();
+        }
+      } else if (it->second != c) {
+        m_hash ^= rule_hash(a, it->second) ^ rule_hash(a, c);
+        it->second = c;
+        m_stale = true;
+        if (m_indexed) {
+          m_index.slots[index_find(a)].second = c;
+        }
+      }
       return true;
     }
     return false;
@@ -344,7 +758,15 @@ namespace cj {
   template<typename Truth, typename Input, typename Id>
   auto fuzzy_classifier<Truth, Input, Id>::add_rule(rule_type const& r) -> bool {
     if (!r.first.empty()) {
-      m_rules.insert(r);
+      if (m_rules.insert(r).second) {
+        m_hash ^= rule_hash(r.first, r.second);
+        m_stale = true;
+        if (m_indexed) {
+          index_insert(r.first, r.second);
+        } else if (m_rules.size() >= index_min_rules) {
+          build_index();
+        }
+      }
       return true;
     }
     return false;
@@ -364,89 +786,758 @@ namespace cj {
   // POP RULE IS HERE!!!!!
 
   template<typename Truth, typename Input, typename Id>
-  auto fuzzy_classifier<Truth, Input, Id>::evaluate(vector<input_type> const& row) const -> id_type {
-    auto truth_by_classes = vector<truth_type>(m_i->num_categories(), truth_type{0});
-    for (auto const& rule : m_rules) {
+  auto fuzzy_classifier<Truth, Input, Id>::make_compiled() const -> compiled_rules {
+    auto cr = compiled_rules{};
+    auto const nliterals = complexity() - size();
+    cr.inputs.reserve(nliterals);
+    cr.sets.reserve(nliterals);
+    cr.memberships.reserve(nliterals);
+    cr.offsets.reserve(size() + 1);
+    cr.classes.reserve(size());
+    cr.columns.reserve(nliterals);
+    cr.offsets.push_back(0);
+    auto first_column = vector<size_t>{0};
+    for (auto n = size_t{0}; n < m_i->num_input(); ++n) {
+      first_column.push_back(first_column.back() + m_i->num_partitions(n));
+    }
+
+    // Rules are grouped by class, so that the evaluation of a row can stop once a class reaches
+    // the unit (the next classes cannot win anymore). Within a class, the rules keep their order
+    // unless the logic is order-independent: then the rules most likely to be active come first
+    // (to reach the unit sooner), and the most selective literals come first (to reach zero
+    // sooner).
+    using literal_type = typename antecedent_type::value_type;
+    auto order = vector<pair<double, typename rules_type::const_iterator>>{};
+    order.reserve(size());
+    for (auto it = m_rules.begin(); it != m_rules.end(); ++it) {
+      auto activity = 1.0;
+      if constexpr (order_independent) {
+        for (auto const& v : it->first) {
+          activity *= selectivity(v.first);
+        }
+      }
+      order.emplace_back(-activity, it);
+    }
+    std::stable_sort(order.begin(), order.end(), [](auto const& a, auto const& b) {
+      return a.second->second < b.second->second
+          || (a.second->second == b.second->second && a.first < b.first);
+    });
+    auto literals = vector<literal_type>{};
+    for (auto const& o : order) {
+      auto const& rule = *o.second;
+      literals.assign(rule.first.begin(), rule.first.end());
+      if constexpr (order_independent) {
+        std::stable_sort(literals.begin(), literals.end(), [this](auto const& a, auto const& b) {
+          return selectivity(a.first) < selectivity(b.first);
+        });
+      }
+      for (auto const& v : literals) {
+        cr.inputs.push_back(v.first);
+        cr.sets.push_back(v.second);
+        cr.memberships.push_back(&m_i->get(v.first, v.second));
+        cr.columns.push_back(first_column[v.first] + v.second);
+        cr.min_row_size = std::max(cr.min_row_size, size_t(v.first) + 1);
+      }
+      cr.offsets.push_back(cr.inputs.size());
+      cr.classes.push_back(rule.second);
+    }
+    cr.used_inputs = cr.inputs;
+    std::sort(cr.used_inputs.begin(), cr.used_inputs.end());
+    cr.used_inputs.erase(std::unique(cr.used_inputs.begin(), cr.used_inputs.end()),
+                         cr.used_inputs.end());
+
+    // Tries: visiting the antecedents of a class in lexicographic order, a rule shares the nodes
+    // of its common prefix with the previous rule and appends the others. The nodes deeper than
+    // the common prefix are closed (their subtree ends) before.
+    auto sorted = vector<typename rules_type::const_iterator>{};
+    sorted.reserve(size());
+    for (auto it = m_rules.begin(); it != m_rules.end(); ++it) {
+      sorted.push_back(it);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](auto const& a, auto const& b) {
+      return a->second < b->second;
+    });
+    auto path = vector<size_t>{}; // Nodes from the root to the last node.
+    auto const close = [&cr, &path](size_t depth) {
+      while (path.size() > depth) {
+        cr.trie_ends[path.back()] = cr.trie_columns.size();
+        path.pop_back();
+      }
+    };
+    for (auto k = size_t{0}; k < sorted.size(); ++k) {
+      auto const& a = sorted[k]->first;
+      auto shared = size_t{0};
+      if (k > 0 && sorted[k - 1]->second == sorted[k]->second) {
+        auto const& prev = sorted[k - 1]->first;
+        auto const m = std::mismatch(prev.begin(), prev.end(), a.begin(), a.end());
+        shared = size_t(std::distance(a.begin(), m.second));
+      }
+      close(shared);
+      for (auto it = a.begin() + shared; it != a.end(); ++it) {
+        path.push_back(cr.trie_columns.size());
+        cr.trie_columns.push_back(first_column[it->first] + it->second);
+        cr.trie_depths.push_back(path.size());
+        cr.trie_ends.push_back(0);
+        cr.trie_terminal.push_back(0);
+        cr.trie_classes.push_back(sorted[k]->second);
+      }
+      cr.trie_terminal[path.back()] = 1;
+      cr.trie_depth = std::max(cr.trie_depth, path.size());
+    }
+    close(0);
+    return cr;
+  }
+
+  template<typename Truth, typename Input, typename Id> template<typename Row>
+  auto fuzzy_classifier<Truth, Input, Id>::evaluate(compiled_rules const& cr,
+      Row const& row, row_buffers& buf) const -> id_type {
+    if (cj_unlikely(row.size() < cr.min_row_size)) {
+      throw std::out_of_range("fuzzy_classifier::evaluate: row is too small for the rules.");
+    }
+    // Degrees of the active fuzzy sets (the others are zero):
+    auto const stamp = ++buf.stamp;
+    for (auto const n : cr.used_inputs) {
+      buf.active.clear();
+      m_i->active_sets(n, row[n], buf.active);
+      for (auto const& a : buf.active) {
+        auto const col = buf.first_columns[n] + a.first;
+        buf.degrees[col] = a.second;
+        buf.stamps[col] = stamp;
+      }
+    }
+
+    auto& truth_by_classes = buf.by_classes;
+    std::fill(truth_by_classes.begin(), truth_by_classes.end(), truth_type{0});
+    auto const nrules = cr.classes.size();
+    for (auto r = size_t{0}; r < nrules; ++r) {
+      auto truth = truth_type{1};
+      for (auto l = cr.offsets[r]; l < cr.offsets[r + 1]; ++l) {
+        if (buf.stamps[cr.columns[l]] != stamp) {
+          truth = truth_type{0}; // Inactive literal.
+          break;
+        }
+        truth = truth && buf.degrees[cr.columns[l]];
+      }
+      auto& agg = truth_by_classes[cr.classes[r]];
+      agg = agg || truth;
+      if (unit_absorbs && agg == truth_type{1}) {
+        return cr.classes[r]; // The previous classes are below the unit, the next ones cannot win.
+      }
+    }
+    return idx_of_maximum(truth_by_classes);
+  }
+
+  template<typename Truth, typename Input, typename Id>
+  auto fuzzy_classifier<Truth, Input, Id>::evaluate(compiled_rules const& cr,
+      membership_tensor_type const& mt, size_t row, vector<truth_type>& truth_by_classes) const
+      -> id_type {
+    std::fill(truth_by_classes.begin(), truth_by_classes.end(), truth_type{0});
+    auto const nrows = mt.nrows();
+    auto const values = mt.column(0);
+    auto const nrules = cr.classes.size();
+    for (auto r = size_t{0}; r < nrules; ++r) {
+      auto truth = truth_type{1};
+      for (auto l = cr.offsets[r]; l < cr.offsets[r + 1] && truth_type{0} < truth; ++l) {
+        truth = truth && values[cr.columns[l] * nrows + row];
+      }
+      auto& agg = truth_by_classes[cr.classes[r]];
+      agg = agg || truth;
+      if (unit_absorbs && agg == truth_type{1}) {
+        return cr.classes[r];
+      }
+    }
+    return idx_of_maximum(truth_by_classes);
+  }
+
+  template<typename Truth, typename Input, typename Id> template<typename Row>
+  auto fuzzy_classifier<Truth, Input, Id>::evaluate_row(Row const& row) const -> id_type {
+    auto buf = make_row_buffers();
+    if (m_indexed) {
+      return evaluate_indexed(row, buf);
+    }
+    return m_stale? evaluate(make_compiled(), row, buf) : evaluate(m_compiled, row, buf);
+  }
+
+  template<typename Truth, typename Input, typename Id> template<typename Row>
+  auto fuzzy_classifier<Truth, Input, Id>::evaluate_indexed(Row const& row,
+      row_buffers& buf) const -> id_type {
+    // Counts the active literals of the rules found in the posting lists of the active sets:
+    auto const stamp = ++buf.stamp;
+    buf.matched.clear();
+    auto const ninputs = m_index.nliterals.size();
+    for (auto n = size_t{0}; n < ninputs; ++n) {
+      if (m_index.nliterals[n] == 0) {
+        continue;
+      }
+      if (cj_unlikely(n >= row.size())) {
+        throw std::out_of_range("fuzzy_classifier::evaluate: row is too small for the rules.");
+      }
+      buf.active.clear();
+      m_i->active_sets(n, row[n], buf.active);
+      auto const& postings = m_index.postings[n];
+      for (auto const& a : buf.active) {
+        auto const col = buf.first_columns[n] + a.first;
+        buf.degrees[col] = a.second;
+        buf.stamps[col] = stamp;
+        if (a.first >= postings.size()) {
+          continue;
+        }
+        for (auto const slot : postings[a.first]) {
+          if (buf.slot_stamps[slot] != stamp) {
+            buf.slot_stamps[slot] = stamp;
+            buf.slot_hits[slot] = 0;
+          }
+          if (++buf.slot_hits[slot] == m_index.slots[slot].first.size()) {
+            buf.matched.push_back(slot);
+          }
+        }
+      }
+    }
+
+    // The disjunction within a class follows the order of the rules (as in the compiled rules)
+    // unless the logic is order-independent:
+    if constexpr (!order_independent) {
+      std::sort(buf.matched.begin(), buf.matched.end(), [this](size_t a, size_t b) {
+        return m_index.slots[a].first < m_index.slots[b].first;
+      });
+    }
+    auto& truth_by_classes = buf.by_classes;
+    std::fill(truth_by_classes.begin(), truth_by_classes.end(), truth_type{0});
+    for (auto const slot : buf.matched) {
+      auto const& rule = m_index.slots[slot];
       auto truth = truth_type{1};
       for (auto const& v : rule.first) {
-        truth = truth && m_i->get(v.first, v.second, row.at(v.first));
+        truth = truth && buf.degrees[buf.first_columns[v.first] + v.second];
       }
-      truth_by_classes[rule.second] = truth_by_classes[rule.second] || truth;
+      auto& agg = truth_by_classes[rule.second];
+      agg = agg || truth;
     }
     return idx_of_maximum(truth_by_classes);
   }
 
+  template<typename Truth, typename Input, typename Id> template<typename Rows>
+  auto fuzzy_classifier<Truth, Input, Id>::evaluate_rows(Rows const& rows) const -> confusion<size_t, double> {
+    auto results = confusion<size_t, double>{m_i->num_categories()};
+    auto buf = make_row_buffers();
+    if (m_indexed) {
+      for (auto const& row : rows) {
+        results.add_count(evaluate_indexed(row.first, buf), row.second);
+      }
+      return results;
+    }
+    auto const cr = m_stale? make_compiled() : compiled_rules{};
+    auto const& rules = m_stale? cr : m_compiled;
+    for (auto const& row : rows) {
+      results.add_count(evaluate(rules, row.first, buf), row.second);
+    }
+    return results;
+  }
+
   template<typename Truth, typename Input, typename Id>
-  auto fuzzy_classifier<Truth, Input, Id>::evaluate_all(data_matrix<input_type, id_type> const& dm)
+  auto fuzzy_classifier<Truth, Input, Id>::evaluate(membership_tensor_type const& mt, size_t row)
+      const -> id_type {
+    assert(mt.num_input() == m_i->num_input());
+    auto truth_by_classes = vector<truth_type>(m_i->num_categories(), truth_type{0});
+    return m_stale? evaluate(make_compiled(), mt, row, truth_by_classes)
+                  : evaluate(m_compiled, mt, row, truth_by_classes);
+  }
+
+  template<typename Truth, typename Input, typename Id>
+  auto fuzzy_classifier<Truth, Input, Id>::evaluate_all(membership_tensor_type const& mt)
       const -> confusion<size_t, double> {
-    auto results = confusion<size_t, double>{m_i->num_categories()};
-    for (auto const& row : dm) {
-      results.add_count(evaluate(row.first), row.second);
+    assert(mt.num_input() == m_i->num_input());
+    auto const ncats = m_i->num_categories();
+    auto results = confusion<size_t, double>{ncats};
+    auto const cr = m_stale? make_compiled() : compiled_rules{};
+    auto const& rules = m_stale? cr : m_compiled;
+    auto const nnodes = rules.trie_columns.size();
+    auto const nrows = mt.nrows();
+
+    // Rows are evaluated by blocks: the conjunction of a trie node and the disjunction into its
+    // class are kernels over contiguous truth values (see truth_kernels.hh), and a block
+    // of memberships and aggregates is small enough to stay in L1. Each depth of the tries has its
+    // own buffer of conjunctions, the depth 0 being the unit. A mask flags the rows still
+    // undecided (no class at the unit yet): a subtree is skipped as soon as the conjunction of its
+    // root is zero on all of them, and the block stops once none is left. The rules of a class are
+    // visited in lexicographic order, so the results are the same as rule-by-rule evaluation.
+    auto conj = vector<truth_type>((rules.trie_depth + 1) * block_rows, truth_type{1});
+    auto by_classes = vector<truth_type>(ncats * block_rows, truth_type{0});
+    auto undecided = vector<unsigned char>(block_rows, 1);
+    for (auto first = size_t{0}; first < nrows; first += block_rows) {
+      auto const len = std::min(block_rows, nrows - first);
+      std::fill(by_classes.begin(), by_classes.end(), truth_type{0});
+      std::fill(undecided.begin(), undecided.end(), 1);
+      for (auto k = size_t{0}; k < nnodes; ) {
+        if constexpr (unit_absorbs) {
+          if (k > 0 && rules.trie_classes[k] != rules.trie_classes[k - 1]) {
+            // The rows where the previous class reached the unit are decided:
+            auto const* const prev = by_classes.data() + rules.trie_classes[k - 1] * block_rows;
+            auto nundecided = size_t{0};
+            for (auto j = size_t{0}; j < len; ++j) {
+              undecided[j] &= (unsigned char)(prev[j] != truth_type{1});
+              nundecided += undecided[j];
+            }
+            if (nundecided == 0) {
+              break;
+            }
+          }
+        }
+        auto* const c = conj.data() + rules.trie_depths[k] * block_rows;
+        auto const* const parent = c - block_rows;
+        auto const* const m = mt.column(rules.trie_columns[k]) + first;
+        auto* const acc = by_classes.data() + rules.trie_classes[k] * block_rows;
+        // Checking a leaf would only save the disjunction, which costs about as much as the check.
+        // Leaves (always terminal) do not need their conjunctions stored:
+        if (rules.trie_ends[k] == k + 1) {
+          conjoin_disjoin(acc, parent, m, len);
+          ++k;
+          continue;
+        }
+        conjoin(parent, m, c, len);
+        auto const* const u = undecided.data();
+        auto active = false;
+        for (auto j = size_t{0}; j < len && !active; ++j) { // Usually stops at the first rows.
+          active = u[j] && truth_type{0} < c[j];
+        }
+        if (!active) {
+          k = rules.trie_ends[k];
+          continue;
+        }
+        if (rules.trie_terminal[k]) {
+          disjoin(acc, c, acc, len);
+        }
+        ++k;
+      }
+      // Same tie-breaking as idx_of_maximum: the first class with the highest truth wins.
+      for (auto j = size_t{0}; j < len; ++j) {
+        auto best = size_t{0};
+        for (auto k = size_t{1}; k < ncats; ++k) {
+          if (by_classes[best * block_rows + j] < by_classes[k * block_rows + j]) {
+            best = k;
+          }
+        }
+        results.add_count(best, mt.output(first + j));
+      }
     }
     return results;
   }
 
+  template<typename Truth, typename Input, typename Id>
+  auto fuzzy_classifier<Truth, Input, Id>::build_index() -> void {
+    m_index = rule_index{};
+    m_index.slots.reserve(m_rules.size());
+    for (auto const& r : m_rules) {
+      index_insert(r.first, r.second);
+    }
+    m_indexed = true;
+  }
+
+  template<typename Truth, typename Input, typename Id>
+  auto fuzzy_classifier<Truth, Input, Id>::index_insert(antecedent_type const& a, id_type c)
+      -> void {
+    auto slot = m_index.slots.size();
+    if (m_index.free_slots.empty()) {
+      m_index.slots.emplace_back(a, c);
+    } else {
+      slot = m_index.free_slots.back();
+      m_index.free_slots.pop_back();
+      m_index.slots[slot] = rule_type{a, c};
+    }
+    for (auto const& v : a) {
+      if (v.first >= m_index.postings.size()) {
+        m_index.postings.resize(v.first + 1);
+        m_index.nliterals.resize(v.first + 1, 0);
+      }
+      auto& postings = m_index.postings[v.first];
+      if (v.second >= postings.size()) {
+        postings.resize(v.second + 1);
+      }
+      postings[v.second].push_back(slot);
+      ++m_index.nliterals[v.first];
+    }
+  }
+
+  template<typename Truth, typename Input, typename Id>
+  auto fuzzy_classifier<Truth, Input, Id>::index_find(antecedent_type const& a) const -> size_t {
+    auto const& v = *a.begin();
+    for (auto const slot : m_index.postings[v.first][v.second]) {
+      if (m_index.slots[slot].first == a) {
+        return slot;
+      }
+    }
+    assert(false);
+    return m_index.slots.size();
+  }
+
+  template<typename Truth, typename Input, typename Id>
+  auto fuzzy_classifier<Truth, Input, Id>::index_erase(antecedent_type const& a) -> void {
+    auto const slot = index_find(a);
+    for (auto const& v : a) {
+      auto& posting = m_index.postings[v.first][v.second];
+      auto it = std::find(posting.begin(), posting.end(), slot);
+      *it = posting.back(); // The order of the posting lists does not matter.
+      posting.pop_back();
+      --m_index.nliterals[v.first];
+    }
+    m_index.slots[slot].first.clear();
+    m_index.free_slots.push_back(slot);
+  }
+
   template<typename Truth, typename Input, typename Id>
   auto fuzzy_classifier<Truth, Input, Id>::evolve(self_type initial, mutate_function const& mut,
       fitness_function const& fit, std::function<bool(double)> const& stop,
       data_matrix<input_type, id_type> const& training, size_t const pop_size, size_t const elites,
-      size_t const t_max, size_t const seed, size_t const n, double const pr) -> self_type {
+      size_t const t_max, size_t const seed, size_t const n, double const pr,
+      size_t const cache_size, size_t const threads) -> self_type {
+    return evolve_impl(std::move(initial), mut, fit, stop, training, pop_size, elites, t_max, seed,
+                       n, pr, cache_size, threads);
+  }
+
+  template<typename Truth, typename Input, typename Id>
+  auto fuzzy_classifier<Truth, Input, Id>::evolve(self_type initial, mutate_function const& mut,
+      tensor_fitness_function const& fit, std::function<bool(double)> const& stop,
+      membership_tensor_type const& training, size_t const pop_size, size_t const elites,
+      size_t const t_max, size_t const seed, size_t const n, double const pr,
+      size_t const cache_size, size_t const threads) -> self_type {
+    return evolve_impl(std::move(initial), mut, fit, stop, training, pop_size, elites, t_max, seed,
+                       n, pr, cache_size, threads);
+  }
+
+  /**
+   * \brief A population of classifiers evolved one generation at a time, each classifier using
+   *        its own random stream derived from (seed, generation, index).
+   */
+  template<typename Truth, typename Input, typename Id> template<typename Fitness, typename Training>
+  class fuzzy_classifier<Truth, Input, Id>::population {
+   public:
+    population(self_type const& initial, mutate_function const& mut, Fitness const& fit,
+               Training const& training, size_t const pop_size, size_t const elites,
+               size_t const seed, size_t const n, double const pr, size_t const cache_size,
+               size_t const threads)
+      : m_mut{mut}, m_fit{fit}, m_training{training}, m_inter{initial.get_interpretation_ptr()},
+        m_pop(pop_size, initial), m_scores(pop_size, 0.0), m_fitnesses{elites},
+        m_cache{cache_size}, m_same_as(pop_size, pop_size), m_seed{seed}, m_n{n}, m_pr{pr},
+        m_threads{threads} {
+    }
+
+    /**
+     * \brief Mutates and evaluates the current generation.
+     */
+    auto evaluate() -> void;
+
+    /**
+     * \brief Replaces the non-elites by the offspring of the elites, moving to the next
+     *        generation.
+     */
+    auto mate() -> void;
+
+    /**
+     * \brief Fitness of the best classifier of the last evaluation.
+     */
+    auto best_fitness() const -> double {
+      return m_fitnesses.maximum_key();
+    }
+
+    /**
+     * \brief Best classifier of the last evaluation.
+     */
+    auto best() -> self_type& {
+      return m_pop[m_fitnesses.maximum().second];
+    }
+
+    /**
+     * \brief Copies of the 'k' best classifiers of the last evaluation, with their fitness.
+     */
+    auto emigrants(size_t k) const -> vector<pair<double, self_type>>;
+
+    /**
+     * \brief Replaces the least fit classifiers by the migrants.
+     */
+    auto immigrate(vector<pair<double, self_type>> const& migrants) -> void;
+
+   private:
+    mutate_function const& m_mut;
+    Fitness const& m_fit;
+    Training const& m_training;
+    interpretation_ptr const m_inter;
+    vector<self_type> m_pop;
+    vector<double> m_scores; // Fitness of each classifier.
+    top_n_multimap<double, size_t> m_fitnesses; // Maps the highest fitness to the population's index in 'm_pop'.
+    lru_cache<size_t, pair<rules_type, double>> m_cache; // Fitness by rules' hash.
+    vector<size_t> m_to_score; // Classifiers that need to be evaluated.
+    vector<size_t> m_same_as; // Index of an identical classifier being evaluated.
+    unordered_map<size_t, size_t> m_pending; // Hash -> index of a classifier being evaluated.
+    size_t const m_seed;
+    size_t const m_n;
+    double const m_pr;
+    size_t const m_threads;
+    size_t m_t = 0; // Generation.
+  };
+
+  template<typename Truth, typename Input, typename Id> template<typename Fitness, typename Training>
+  auto fuzzy_classifier<Truth, Input, Id>::population<Fitness, Training>::evaluate() -> void {
+    auto const pop_size = m_pop.size();
+
+    // Mutates, each classifier with its own random stream (even numbers):
+    parallel_for(pop_size, m_threads, [&](size_t p) {
+      auto rng = std::mt19937_64(derive_seed(m_seed, 2 * m_t, p));
+      auto const num_mutations = std::binomial_distribution<size_t>(m_n, m_pr)(rng);
+      for (auto m = size_t{0}; m < num_mutations; ++m) {
+        m_mut(m_pop[p], rng);
+      }
+    });
+
+    // Finds the fitnesses that are already known:
+    m_to_score.clear();
+    m_pending.clear();
+    for (auto p = size_t{0}; p < pop_size; ++p) {
+      m_same_as[p] = pop_size;
+      auto const h = m_pop[p].hash();
+      auto const cached = m_cache.find(h);
+      if (cached != nullptr && cached->first == m_pop[p].rules()) {
+        m_scores[p] = cached->second;
+        continue;
+      }
+      auto const it = m_pending.find(h);
+      if (it != m_pending.end() && m_pop[it->second].rules() == m_pop[p].rules()) {
+        m_same_as[p] = it->second;
+      } else {
+        m_pending[h] = p;
+        m_to_score.push_back(p);
+      }
+    }
+
+    // Evaluates the others:
+    parallel_for(m_to_score.size(), m_threads, [&](size_t k) {
+      auto& c = m_pop[m_to_score[k]];
+      c.compile();
+      m_scores[m_to_score[k]] = m_fit(c, m_training);
+    });
+    for (auto const p : m_to_score) {
+      m_cache.insert(m_pop[p].hash(), {m_pop[p].rules(), m_scores[p]});
+    }
+
+    m_fitnesses.clear();
+    for (auto p = size_t{0}; p < pop_size; ++p) {
+      if (m_same_as[p] != pop_size) {
+        m_scores[p] = m_scores[m_same_as[p]];
+      }
+      m_fitnesses.try_insert(m_scores[p], p);
+    }
+  }
+
+  template<typename Truth, typename Input, typename Id> template<typename Fitness, typename Training>
+  auto fuzzy_classifier<Truth, Input, Id>::population<Fitness, Training>::mate() -> void {
+    // Only mate the non-elites, keep the elites untouched (odd numbers for the random streams):
+    auto const fittest = m_fitnesses.set_of_values();
+    parallel_for(m_pop.size(), m_threads, [&](size_t p) {
+      if (fittest.find(p) == fittest.end()) {
+        auto rng = std::mt19937_64(derive_seed(m_seed, 2 * m_t + 1, p));
+        auto const parents = pick_unique_pair(fittest, rng);
+        m_pop[p] = self_type {
+          m_inter,
+          map_intersection_split_union(m_pop[parents[0]].rules(), m_pop[parents[1]].rules(), rng)
+        };
+      }
+    });
+    ++m_t;
+  }
+
+  template<typename Truth, typename Input, typename Id> template<typename Fitness, typename Training>
+  auto fuzzy_classifier<Truth, Input, Id>::population<Fitness, Training>::emigrants(size_t k) const
+      -> vector<pair<double, self_type>> {
+    auto ms = vector<pair<double, self_type>>{};
+    for (auto it = m_fitnesses.rbegin(); it != m_fitnesses.rend() && ms.size() < k; ++it) {
+      ms.emplace_back(it->first, m_pop[it->second]);
+    }
+    return ms;
+  }
+
+  template<typename Truth, typename Input, typename Id> template<typename Fitness, typename Training>
+  auto fuzzy_classifier<Truth, Input, Id>::population<Fitness, Training>::immigrate(
+      vector<pair<double, self_type>> const& migrants) -> void {
+    auto by_fitness = vector<size_t>(m_pop.size());
+    std::iota(by_fitness.begin(), by_fitness.end(), size_t{0});
+    std::stable_sort(by_fitness.begin(), by_fitness.end(), [this](size_t a, size_t b) {
+      return m_scores[a] < m_scores[b];
+    });
+    auto const nreplaced = std::min(migrants.size(), m_pop.size() - m_fitnesses.max_size());
+    for (auto k = size_t{0}; k < nreplaced; ++k) {
+      m_pop[by_fitness[k]] = migrants[k].second;
+      m_scores[by_fitness[k]] = migrants[k].first;
+    }
+    m_fitnesses.clear();
+    for (auto p = size_t{0}; p < m_pop.size(); ++p) {
+      m_fitnesses.try_insert(m_scores[p], p);
+    }
+  }
+
+  template<typename Truth, typename Input, typename Id> template<typename Fitness, typename Training>
+  auto fuzzy_classifier<Truth, Input, Id>::evolve_impl(self_type initial, mutate_function const& mut,
+      Fitness const& fit, std::function<bool(double)> const& stop, Training const& training,
+      size_t const pop_size, size_t const elites, size_t const t_max, size_t const seed,
+      size_t const n, double const pr, size_t const cache_size, size_t const threads)
+      -> self_type {
     assert(pop_size > 0);
     assert(elites > 0);
     assert(elites < pop_size);
     assert(t_max > 0);
 
-    auto mutations = std::binomial_distribution<size_t>(n, pr);
-    auto const inter = initial.get_interpretation_ptr();
+    auto pop = population<Fitness, Training>{initial, mut, fit, training, pop_size, elites, seed, n,
+                                             pr, cache_size, threads};
+    for (auto t = size_t{0}; ; ++t) {
+      pop.evaluate();
+      if (stop(pop.best_fitness()) || t == t_max) {
+        break;
+      }
+      pop.mate();
+    }
+    auto& best = pop.best();
+    best.compile();
+    return best;
+  }
 
-    auto const non_elites = pop_size - elites;
-    auto rng = std::mt19937_64(seed);
+  template<typename Truth, typename Input, typename Id>
+  auto fuzzy_classifier<Truth, Input, Id>::evolve_islands(self_type initial,
+      mutate_function const& mut, tensor_fitness_function const& fit,
+      std::function<bool(double)> const& stop, membership_tensor_type const& training,
+      size_t const islands, size_t const interval, size_t const migrants,
+      migration_topology const topology, size_t const pop_size, size_t const elites,
+      size_t const t_max, size_t const seed, size_t const n, double const pr,
+      size_t const cache_size) -> self_type {
+    assert(islands > 0);
+    assert(interval > 0);
+    assert(migrants <= elites);
+    assert(elites < pop_size);
+    assert(t_max > 0);
 
-    // Creates the initial population of solutions:
-    auto pop = vector<self_type>(pop_size, initial);
-    auto fitnesses = top_n_multimap<double, size_t>(elites); // Maps the highest fitness to the population's index in 'pop'.
+    using population_type = population<tensor_fitness_function, membership_tensor_type>;
+    auto pops = vector<population_type>{};
+    pops.reserve(islands);
+    for (auto i = size_t{0}; i < islands; ++i) {
+      pops.emplace_back(initial, mut, fit, training, pop_size, elites, derive_seed(seed, islands, i),
+                        n, pr, cache_size, 1);
+    }
 
-    auto t = size_t{0};
-    while (true) {
-      // Mutates and store fitness:
-      fitnesses.clear();
-      for (auto p = size_t{0}; p < pop_size; ++p) {
-        auto const num_mutations = mutations(rng);
-        for (auto m = size_t{0}; m < num_mutations; ++m) {
-          mut(pop[p], rng);
+    auto done = vector<char>(islands, false); // Whether an island met the stopping criteria.
+    for (auto t = size_t{0}; t <= t_max; t += interval) {
+      // Each island evolves on its own thread until the next migration:
+      parallel_for(islands, islands, [&](size_t i) {
+        for (auto g = t; g < std::min(t + interval, t_max + 1); ++g) {
+          if (g != 0) {
+            pops[i].mate();
+          }
+          pops[i].evaluate();
+          if (stop(pops[i].best_fitness())) {
+            done[i] = true;
+            return;
+          }
         }
-        auto const fitness = fit(pop[p], training);
-        fitnesses.try_insert(fitness, p);
-      }
-      if (stop(fitnesses.maximum_key()) || t++ == t_max) {
+      });
+      if (std::find(done.begin(), done.end(), true) != done.end() || t + interval > t_max) {
         break;
       }
 
-      auto const fittest = fitnesses.set_of_values();
-      // Only mate the non-elites, keep the elites untouched:
-      for (auto p = size_t{0}; p < pop_size; ++p) {
-        if (fittest.find(p) == fittest.end()) {
-          auto const parents = pick_unique_pair(fittest, rng);
-          pop[p] = self_type {
-            inter,
-            map_intersection_split_union(pop[parents[0]].rules(), pop[parents[1]].rules(), rng)
-          };
+      auto outgoing = vector<vector<pair<double, self_type>>>{};
+      for (auto& p : pops) {
+        outgoing.push_back(p.emigrants(migrants));
+      }
+      for (auto i = size_t{0}; i < islands && islands > 1; ++i) {
+        auto incoming = vector<pair<double, self_type>>{};
+        for (auto j = size_t{0}; j < islands; ++j) {
+          auto const from_j = topology == migration_topology::ring?
+            j == (i + islands - 1) % islands : j != i;
+          if (from_j) {
+            incoming.insert(incoming.end(), outgoing[j].begin(), outgoing[j].end());
+          }
         }
+        pops[i].immigrate(incoming);
       }
     }
-    return pop[fitnesses.maximum().second];
+
+    auto best = size_t{0};
+    for (auto i = size_t{1}; i < islands; ++i) {
+      if (pops[best].best_fitness() < pops[i].best_fitness()) {
+        best = i;
+      }
+    }
+    auto& c = pops[best].best();
+    c.compile();
+    return c;
   }
 
   template<typename Truth, typename Input, typename Id>
   auto fuzzy_classifier<Truth, Input, Id>::interpretation::add_triangular_partition(string const& name,
       size_t nsets, input_type a, input_type b) -> void {
+    auto sets = make_triangles(nsets, a, b, truth_type{0}, truth_type{1});
+    auto const suffix = tabulate(sets);
+    // The active sets are found from the grid unless lookup tables have coarser cells or another
+    // range (which could activate sets further away):
+    auto const step = nsets < 2? input_type(0) : (b - a) / input_type(nsets - 1);
+    auto const cell = m_lut_bits == 0? input_type(0)
+                    : (m_lut_end - m_lut_begin) / input_type(size_t{1} << m_lut_bits);
+    auto const on_grid = m_lut_bits == 0 || (m_lut_begin == a && m_lut_end == b && cell < step);
+    m_grids.emplace_back(a, on_grid? step : input_type(0));
     m_input_names.push_back(name);
-    m_partitions.push_back(make_triangles(nsets, a, b, truth_type{0}, truth_type{1}));
+    m_partitions.push_back(std::move(sets));
     m_partition_names.push_back("Triangular_{" + boost::lexical_cast<string>(nsets) + "}("
-      + boost::lexical_cast<string>(a) + ", " + boost::lexical_cast<string>(b) + ")");
+      + boost::lexical_cast<string>(a) + ", " + boost::lexical_cast<string>(b) + ")" + suffix);
     m_labels.push_back(make_labels(nsets));
   }
 
+  template<typename Truth, typename Input, typename Id>
+  auto fuzzy_classifier<Truth, Input, Id>::interpretation::add_partition(string const& name,
+      vector<fuzzy_set_type> sets, string const& partition_name, vector<string> labels) -> void {
+    if (labels.empty()) {
+      labels = make_labels(sets.size());
+    }
+    if (labels.size() != sets.size()) {
+      throw std::invalid_argument("interpretation::add_partition: needs one label per fuzzy set.");
+    }
+    auto const suffix = tabulate(sets);
+    m_grids.emplace_back(input_type(0), input_type(0));
+    m_input_names.push_back(name);
+    m_partitions.push_back(std::move(sets));
+    m_partition_names.push_back(partition_name + suffix);
+    m_labels.push_back(std::move(labels));
+  }
+
+  template<typename Truth, typename Input, typename Id>
+  auto fuzzy_classifier<Truth, Input, Id>::interpretation::active_sets(id_type n, input_type x,
+      vector<pair<id_type, truth_type>>& out) const -> void {
+    auto const& sets = m_partitions.at(n);
+    auto const [begin, step] = m_grids[n];
+    auto lo = size_t{0}, hi = sets.size();
+    if (step > input_type(0) && !std::isnan(x)) {
+      // 'x' is in the cell between the apexes of the sets 'i' and 'i + 1'. The neighbors are
+      // checked too, in case of rounding errors on the breakpoints:
+      auto const t = (x - begin) / step;
+      auto const last = sets.size() - 2; // Last cell.
+      auto const i = t > input_type(0)? std::min(size_t(std::min(t, input_type(last))), last)
+                                      : size_t{0};
+      lo = i > 0? i - 1 : 0;
+      hi = std::min(i + 3, sets.size());
+    }
+    for (auto s = lo; s < hi; ++s) {
+      auto const d = sets[s](x);
+      if (truth_type{0} < d) {
+        out.emplace_back(id_type(s), d);
+      }
+    }
+  }
+
+  template<typename Truth, typename Input, typename Id>
+  auto fuzzy_classifier<Truth, Input, Id>::interpretation::tabulate(vector<fuzzy_set_type>& sets)
+      const -> string {
+    if (m_lut_bits == 0) {
+      return "";
+    }
+    for (auto& s : sets) {
+      s = fuzzy_set_type::tabulate(s, m_lut_bits, m_lut_begin, m_lut_end);
+    }
+    return " LUT_{2^" + boost::lexical_cast<string>(m_lut_bits) + "}";
+  }
+
   template<typename Truth, typename Input, typename Id>
   auto show_rule(std::ostream& os, typename fuzzy_classifier<Truth, Input, Id>::rule_type const& p,
       typename fuzzy_classifier<Truth, Input, Id>::interpretation const* i) -> void {
@@ -477,7 +1568,12 @@ namespace cj {
     auto p = rule_type{*it};
 //    show_rule<Truth, Input, Id>(std::cout, p, get_raw_interpretation_ptr());
 //    std::cout << "\"\n";
+    if (m_indexed) {
+      index_erase(p.first);
+    }
     m_rules.erase(it);
+    m_hash ^= rule_hash(p.first, p.second);
+    m_stale = true;
     return p;
   }
 
@@ -511,10 +1607,7 @@ namespace std {
   template<typename Truth, typename Input, typename ID>
   struct hash<cj::fuzzy_classifier<Truth, Input, ID>> {
     auto operator()(cj::fuzzy_classifier<Truth, Input, ID> const& kb) const -> size_t {
-      auto seed = size_t{51274857491742893LU};
-      for (auto const& r : kb) {
-        cj::std_hash_combine(seed, r);
-      }
+      auto seed = size_t{kb.hash()};
       cj::std_hash_combine(seed, kb.get_interpretation_ptr());
       return seed;
     }
@@ -0,0 +1,212 @@
+/**
+ * # Summary
+ *
+ * Dense tensor of membership degrees (rows x inputs x fuzzy sets) computed once for a dataset and
+ * an interpretation, so that classifiers can be evaluated by indexing instead of calling the
+ * fuzzy sets for every row, input, and fuzzy set.
+ */
+#ifndef CJ_MEMBERSHIP_TENSOR_HH_
+#define CJ_MEMBERSHIP_TENSOR_HH_
+
+#include "cj/common.hh"
+
+namespace cj {
+
+  namespace detail {
+
+    // Whether the rows are stored by column (e.g. a data_matrix), with column(n) and outputs()
+    // giving contiguous spans.
+    template<typename Rows, typename = void>
+    struct has_column_spans : std::false_type {};
+
+    template<typename Rows>
+    struct has_column_spans<Rows, std::void_t<decltype(std::declval<Rows const&>().column(size_t{}).data()),
+                                              decltype(std::declval<Rows const&>().outputs().data())>>
+      : std::true_type {};
+
+    // Whether the rows are a view of the rows of a data_matrix given by indices (a
+    // data_matrix_view), whose columns are gathered straight from the data_matrix.
+    template<typename Rows, typename = void>
+    struct has_row_indices : std::false_type {};
+
+    template<typename Rows>
+    struct has_row_indices<Rows, std::void_t<decltype(std::declval<Rows const&>().matrix().column(size_t{}).data()),
+                                             decltype(std::declval<Rows const&>().indices().data())>>
+      : std::true_type {};
+
+  } /* end namespace detail */
+
+  /**
+   * \brief Membership degrees of every row of a dataset to every fuzzy set of an interpretation,
+   *        along with the outputs of the rows.
+   *
+   * The degrees are stored column-major: the column of the fuzzy set 's' of input 'n' (at index
+   * column_index(n, s)) holds the degrees of all rows contiguously.
+   *
+   * \tparam Truth    Type of the truth values (membership degrees).
+   * \tparam Output   Type of the outputs (category IDs).
+   */
+  template<typename Truth, typename Output = uint32_t>
+  class membership_tensor {
+   public:
+    using truth_type = Truth;
+    using output_type = Output;
+
+    /**
+     * \brief Fuzzifies a range of (inputs, output) rows (e.g. a data_matrix) with an
+     *        interpretation.
+     */
+    template<typename Rows, typename Interpretation>
+    membership_tensor(Rows const& rows, Interpretation const& i);
+
+    /**
+     * \brief Copies the degrees of some rows of another tensor (e.g. the rows of a fold), in the
+     *        given order, instead of fuzzifying them again.
+     */
+    membership_tensor(membership_tensor const& mt, vector<size_t> const& rows);
+
+    /**
+     * \brief Number of rows.
+     */
+    auto nrows() const -> size_t {
+      return m_outputs.size();
+    }
+
+    /**
+     * \brief Number of input variables.
+     */
+    auto num_input() const -> size_t {
+      return m_first_column.size() - 1;
+    }
+
+    /**
+     * \brief Total number of fuzzy sets (i.e. the number of columns).
+     */
+    auto num_columns() const -> size_t {
+      return m_first_column.back();
+    }
+
+    /**
+     * \brief Index of the column for the fuzzy set 's' of the input 'n'.
+     */
+    auto column_index(size_t n, size_t s) const -> size_t {
+      return m_first_column[n] + s;
+    }
+
+    /**
+     * \brief Pointer to the nrows() contiguous membership degrees of a column.
+     */
+    auto column(size_t c) const -> truth_type const* {
+      return m_values.data() + c * nrows();
+    }
+
+    /**
+     * \brief Membership degree of row 'r' to the fuzzy set 's' of input 'n'.
+     */
+    auto operator()(size_t r, size_t n, size_t s) const -> truth_type {
+      return m_values[column_index(n, s) * nrows() + r];
+    }
+
+    /**
+     * \brief Output of row 'r'.
+     */
+    auto output(size_t r) const -> output_type {
+      return m_outputs[r];
+    }
+
+    /**
+     * \brief Outputs of all rows.
+     */
+    auto outputs() const -> vector<output_type> const& {
+      return m_outputs;
+    }
+
+   private:
+    vector<truth_type> m_values; // Column-major membership degrees.
+    vector<size_t> m_first_column; // Index of the first column of each input (+ total at the end).
+    vector<output_type> m_outputs; // Output of each row.
+  };
+
+  template<typename Truth, typename Output> template<typename Rows, typename Interpretation>
+  membership_tensor<Truth, Output>::membership_tensor(Rows const& rows, Interpretation const& i) {
+    auto const ninput = i.num_input();
+    m_first_column.reserve(ninput + 1);
+    m_first_column.push_back(0);
+    for (auto n = size_t{0}; n < ninput; ++n) {
+      m_first_column.push_back(m_first_column.back() + i.num_partitions(n));
+    }
+    using input_type = typename Interpretation::input_type;
+    if constexpr (detail::has_column_spans<Rows>::value) {
+      auto const outputs = rows.outputs();
+      m_outputs.assign(outputs.begin(), outputs.end());
+    } else if constexpr (detail::has_row_indices<Rows>::value) {
+      auto const outputs = rows.matrix().outputs();
+      m_outputs.reserve(rows.indices().size());
+      for (auto const r : rows.indices()) {
+        m_outputs.push_back(outputs[r]);
+      }
+    } else {
+      for (auto const& row : rows) {
+        m_outputs.push_back(row.second);
+      }
+    }
+    auto const nr = nrows();
+    m_values.resize(num_columns() * nr, truth_type{0});
+    // Columns stored contiguously are fuzzified in place:
+    if constexpr (detail::has_column_spans<Rows>::value) {
+      if constexpr (std::is_same_v<std::decay_t<decltype(*rows.column(0).data())>, input_type>) {
+        for (auto n = size_t{0}; n < ninput; ++n) {
+          auto const xs = rows.column(n);
+          auto const& sets = i.get(n);
+          for (auto s = size_t{0}; s < sets.size(); ++s) {
+            sets[s](xs.data(), nr, m_values.data() + column_index(n, s) * nr);
+          }
+        }
+        return;
+      }
+    }
+    // Each input is gathered once, then every fuzzy set fills its column in one call:
+    auto xs = vector<input_type>{};
+    xs.reserve(nr);
+    for (auto n = size_t{0}; n < ninput; ++n) {
+      xs.clear();
+      if constexpr (detail::has_column_spans<Rows>::value) {
+        auto const column = rows.column(n);
+        xs.assign(column.begin(), column.end());
+      } else if constexpr (detail::has_row_indices<Rows>::value) {
+        auto const column = rows.matrix().column(n);
+        for (auto const r : rows.indices()) {
+          xs.push_back(column[r]);
+        }
+      } else {
+        for (auto const& row : rows) {
+          xs.push_back(row.first.at(n));
+        }
+      }
+      auto const& sets = i.get(n);
+      for (auto s = size_t{0}; s < sets.size(); ++s) {
+        sets[s](xs.data(), nr, m_values.data() + column_index(n, s) * nr);
+      }
+    }
+  }
+
+  template<typename Truth, typename Output>
+  membership_tensor<Truth, Output>::membership_tensor(membership_tensor const& mt, vector<size_t> const& rows)
+    : m_first_column{mt.m_first_column} {
+    m_outputs.reserve(rows.size());
+    for (auto const r : rows) {
+      m_outputs.push_back(mt.output(r));
+    }
+    m_values.resize(num_columns() * rows.size(), truth_type{0});
+    for (auto c = size_t{0}; c < num_columns(); ++c) {
+      auto const* const from = mt.column(c);
+      auto* const to = m_values.data() + c * rows.size();
+      for (auto j = size_t{0}; j < rows.size(); ++j) {
+        to[j] = from[rows[j]];
+      }
+    }
+  }
+
+} /* end namespace cj */
+
+#endif
@@ -0,0 +1,183 @@
+/**
+ * # Summary
+ *
+ * Evaluates a rule base under the three fuzzy logics in a single pass over the memberships.
+ */
+#ifndef CJ_MULTI_LOGIC_HH_
+#define CJ_MULTI_LOGIC_HH_
+
+#include <array>
+#include "cj/common.hh"
+#include "cj/math/truth.hh"
+#include "cj/math/confusion.hh"
+#include "cj/logics/fuzzy_classifier.hh"
+
+namespace cj {
+
+  /**
+   * \brief The fuzzy logics of truth.hh, in the order of the results of evaluate_all_logics.
+   */
+  enum class fuzzy_logic : size_t {
+    lukasiewicz,
+    godel,
+    product
+  };
+
+  /**
+   * \brief Number of fuzzy logics.
+   */
+  constexpr size_t num_fuzzy_logics = 3;
+
+  /**
+   * \brief Name of a fuzzy logic.
+   */
+  inline auto fuzzy_logic_name(fuzzy_logic l) -> string {
+    switch (l) {
+      case fuzzy_logic::lukasiewicz:
+        return "Łukasiewicz";
+      case fuzzy_logic::godel:
+        return "Gödel-Dummett";
+      default: // case fuzzy_logic::product:
+        return "Product";
+    }
+  }
+
+  /**
+   * \brief Which fuzzy logic a truth type implements.
+   */
+  template<typename Truth>
+  struct fuzzy_logic_of;
+
+  template<typename F>
+  struct fuzzy_logic_of<lukasiewicz<F>> {
+    static constexpr fuzzy_logic value = fuzzy_logic::lukasiewicz;
+  };
+
+  template<typename F>
+  struct fuzzy_logic_of<godel<F>> {
+    static constexpr fuzzy_logic value = fuzzy_logic::godel;
+  };
+
+  template<typename F>
+  struct fuzzy_logic_of<product<F>> {
+    static constexpr fuzzy_logic value = fuzzy_logic::product;
+  };
+
+  /**
+   * \brief Evaluates the rules of a classifier under the Łukasiewicz, Gödel-Dummett and product
+   *        logics at once: the membership degrees of a block of rows are read once and feed the
+   *        conjunctions of the three logics. The partitions give the same degrees whatever the
+   *        logic, so any of them can be used to build the tensor. The rules are visited in the
+   *        order of the rule base, and the results are the same as those of evaluate_all with
+   *        each logic.
+   *
+   * \param c             Classifier (its logic only determines the type of the tensor).
+   * \param mt            Membership tensor built with the classifier's interpretation.
+   * \param predictions   If not null, receives the prediction of each row for each logic.
+   * \return              Confusion matrix of each logic (indexed by fuzzy_logic).
+   */
+  template<typename Truth, typename Input, typename Id>
+  auto evaluate_all_logics(fuzzy_classifier<Truth, Input, Id> const& c,
+                           membership_tensor<Truth, Id> const& mt,
+                           vector<std::array<Id, num_fuzzy_logics>>* predictions = nullptr)
+      -> std::array<confusion<size_t, double>, num_fuzzy_logics> {
+    using float_type = typename Truth::value_type;
+    using luka_type = lukasiewicz<float_type>;
+    using godel_type = godel<float_type>;
+    using prod_type = product<float_type>;
+    constexpr auto block_rows = size_t{256};
+    constexpr auto il = size_t(fuzzy_logic::lukasiewicz);
+    constexpr auto ig = size_t(fuzzy_logic::godel);
+    constexpr auto ip = size_t(fuzzy_logic::product);
+
+    auto const ncats = c.get_raw_interpretation_ptr()->num_categories();
+    auto const nrows = mt.nrows();
+    auto results = std::array<confusion<size_t, double>, num_fuzzy_logics>{
+      confusion<size_t, double>{ncats}, confusion<size_t, double>{ncats},
+      confusion<size_t, double>{ncats}
+    };
+    if (predictions != nullptr) {
+      predictions->resize(nrows);
+    }
+
+    // Rules grouped by class, in the order of the rule base within a class:
+    auto rules = vector<typename fuzzy_classifier<Truth, Input, Id>::const_iterator>{};
+    for (auto it = c.begin(); it != c.end(); ++it) {
+      rules.push_back(it);
+    }
+    std::stable_sort(rules.begin(), rules.end(), [](auto const& a, auto const& b) {
+      return a->second < b->second;
+    });
+
+    auto conj_l = vector<luka_type>(block_rows, luka_type{1});
+    auto conj_g = vector<godel_type>(block_rows, godel_type{1});
+    auto conj_p = vector<prod_type>(block_rows, prod_type{1});
+    auto by_l = vector<luka_type>(ncats * block_rows, luka_type{0});
+    auto by_g = vector<godel_type>(ncats * block_rows, godel_type{0});
+    auto by_p = vector<prod_type>(ncats * block_rows, prod_type{0});
+    for (auto first = size_t{0}; first < nrows; first += block_rows) {
+      auto const len = std::min(block_rows, nrows - first);
+      std::fill(by_l.begin(), by_l.end(), luka_type{0});
+      std::fill(by_g.begin(), by_g.end(), godel_type{0});
+      std::fill(by_p.begin(), by_p.end(), prod_type{0});
+      for (auto const& rule : rules) {
+        std::fill(conj_l.begin(), conj_l.end(), luka_type{1});
+        std::fill(conj_g.begin(), conj_g.end(), godel_type{1});
+        std::fill(conj_p.begin(), conj_p.end(), prod_type{1});
+        auto active = true;
+        for (auto const& v : rule->first) {
+          auto const* const m = mt.column(mt.column_index(v.first, v.second)) + first;
+          for (auto j = size_t{0}; j < len; ++j) {
+            auto const x = m[j].value;
+            conj_l[j] = conj_l[j] && luka_type{x};
+            conj_g[j] = conj_g[j] && godel_type{x};
+            conj_p[j] = conj_p[j] && prod_type{x};
+          }
+          // A Gödel or product conjunction is zero iff a literal is zero, and then so is the
+          // Łukasiewicz conjunction:
+          active = false;
+          for (auto j = size_t{0}; j < len && !active; ++j) {
+            active = prod_type{0} < conj_p[j];
+          }
+          if (!active) {
+            break;
+          }
+        }
+        if (!active) {
+          continue;
+        }
+        auto const offset = rule->second * block_rows;
+        disjoin(by_l.data() + offset, conj_l.data(), by_l.data() + offset, len);
+        disjoin(by_g.data() + offset, conj_g.data(), by_g.data() + offset, len);
+        disjoin(by_p.data() + offset, conj_p.data(), by_p.data() + offset, len);
+      }
+      // Same tie-breaking as idx_of_maximum: the first class with the highest truth wins.
+      auto const best = [ncats](auto const& by_classes, size_t j) {
+        auto b = size_t{0};
+        for (auto k = size_t{1}; k < ncats; ++k) {
+          if (by_classes[b * block_rows + j] < by_classes[k * block_rows + j]) {
+            b = k;
+          }
+        }
+        return b;
+      };
+      for (auto j = size_t{0}; j < len; ++j) {
+        auto const bl = best(by_l, j), bg = best(by_g, j), bp = best(by_p, j);
+        auto const observed = mt.output(first + j);
+        results[il].add_count(bl, observed);
+        results[ig].add_count(bg, observed);
+        results[ip].add_count(bp, observed);
+        if (predictions != nullptr) {
+          auto& p = (*predictions)[first + j];
+          p[il] = Id(bl);
+          p[ig] = Id(bg);
+          p[ip] = Id(bp);
+        }
+      }
+    }
+    return results;
+  }
+
+} /* end namespace cj */
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * # Summary
+ *
+ * A dataset prepared once for a fuzzy classifier: the data, the interpretation and the membership
+ * tensor of the data, shared read-only by any number of concurrent evolutions and evaluations.
+ * The data are a view, so that the datasets prepared from the splits or samples of a data_matrix
+ * share its rows.
+ */
+#ifndef CJ_PREPARED_DATASET_HH_
+#define CJ_PREPARED_DATASET_HH_
+
+#include <memory>
+#include "cj/common.hh"
+#include "cj/data/data_matrix.hh"
+#include "cj/data/data_matrix_view.hh"
+#include "cj/logics/membership_tensor.hh"
+
+namespace cj {
+
+  /**
+   * \brief Bundles a data matrix, an interpretation and the membership tensor of the data under
+   *        the interpretation. It can only be built as a shared pointer to a const object, which
+   *        the users keep for as long as they need the data: every member is then immutable and
+   *        safe to read from several threads.
+   *
+   * The interpretation is shared with the classifiers built from it, and must not be modified
+   * once the dataset is prepared (the tensor would no longer match it).
+   */
+  template<typename Classifier>
+  class prepared_dataset {
+   public:
+    using classifier_type = Classifier;
+    using input_type = typename classifier_type::input_type;
+    using id_type = typename classifier_type::id_type;
+    using rules_type = typename classifier_type::rules_type;
+    using interpretation_ptr = typename classifier_type::interpretation_ptr;
+    using membership_tensor_type = typename classifier_type::membership_tensor_type;
+    using data_type = data_matrix<input_type, id_type>;
+    using view_type = data_matrix_view<input_type, id_type>;
+    using const_ptr = std::shared_ptr<prepared_dataset const>;
+
+    /**
+     * \brief Fuzzifies 'data' with the interpretation 'i'.
+     */
+    static auto make(data_type data, interpretation_ptr i) -> const_ptr {
+      return make(view_type{std::make_shared<data_type const>(std::move(data))}, std::move(i));
+    }
+
+    /**
+     * \brief Fuzzifies the rows of a view with the interpretation 'i', without copying them. The
+     *        view should share the ownership of its data_matrix (or the data_matrix must outlive
+     *        the dataset).
+     */
+    static auto make(view_type data, interpretation_ptr i) -> const_ptr {
+      return const_ptr{new prepared_dataset{std::move(data), std::move(i)}};
+    }
+
+    /**
+     * \brief The rows of the data.
+     */
+    auto data() const -> view_type const& {
+      return m_data;
+    }
+
+    /**
+     * \brief The interpretation used to fuzzify the data.
+     */
+    auto interpretation() const -> interpretation_ptr const& {
+      return m_i;
+    }
+
+    /**
+     * \brief Membership degrees of the data, to evaluate the classifiers built with the
+     *        interpretation.
+     */
+    auto memberships() const -> membership_tensor_type const& {
+      return m_memberships;
+    }
+
+    /**
+     * \brief Number of rows.
+     */
+    auto nrows() const -> size_t {
+      return m_memberships.nrows();
+    }
+
+    /**
+     * \brief A classifier with the given rules that uses the interpretation of the dataset.
+     */
+    auto classifier(rules_type const& rules = {}) const -> classifier_type {
+      return classifier_type{m_i, rules};
+    }
+
+   private:
+    prepared_dataset(view_type data, interpretation_ptr i)
+      : m_data{std::move(data)}, m_i{std::move(i)}, m_memberships{m_data, *m_i} {
+    }
+
+    view_type const m_data;
+    interpretation_ptr const m_i;
+    membership_tensor_type const m_memberships;
+  };
+
+} /* end namespace cj */
+
+#endif
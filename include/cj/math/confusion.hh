@@ -78,6 +78,12 @@ namespace cj {
      */
     auto sub_count(size_t predicted, size_t observed, count_type sub = count_type{1}) -> void;
 
+    /**
+     * \brief Adds the counts of another confusion matrix of the same dimension (e.g. to pool
+     *        the results of several folds or chunks of data).
+     */
+    auto operator+=(confusion const& other) -> confusion&;
+
     /**
      * \brief Returns the number of true positives for class 'c'.
      */
@@ -191,6 +197,14 @@ namespace cj {
     }
   }
 
+  template<typename Count, typename Float>
+  auto confusion<Count, Float>::operator+=(confusion const& other) -> confusion& {
+    assert(other.m_dim == m_dim);
+    m_c += other.m_c;
+    m_count += other.m_count;
+    return *this;
+  }
+
   template<typename Count, typename Float>
   auto confusion<Count, Float>::tss(size_t c) const -> float_type {
     auto const tp = true_positives(c);
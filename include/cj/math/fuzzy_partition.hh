@@ -4,6 +4,11 @@
 #ifndef CJ_FUZZY_PARTITION_HH_
 #define CJ_FUZZY_PARTITION_HH_
 
+#include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <type_traits>
 #include "cj/common.hh"
 
 namespace cj {
@@ -48,6 +53,273 @@ namespace cj {
     return ls;
   }
 
+  /**
+   * \brief Shapes of the closed-form fuzzy sets (see fuzzy_set).
+   */
+  enum class fuzzy_set_kind : uint32_t {
+    slope,
+    triangle,
+    trapezoid,
+    gaussian,
+    interval,
+    table,
+    function
+  };
+
+  /**
+   * \brief A fuzzy set (membership function Input -> Truth) stored as the plain parameters of a
+   *        closed-form shape, so that it can be inlined and evaluated over arrays of inputs. Any
+   *        std::function can still be used as a fallback (fuzzy_set_kind::function), at the cost
+   *        of an indirect call per input.
+   */
+  template<typename Input, typename Truth>
+  class fuzzy_set {
+   public:
+    using input_type = Input;
+    using truth_type = Truth;
+    using function_type = std::function<truth_type(input_type)>;
+    using value_type = typename truth_type::value_type;
+    // Degrees are computed in the widest of the input and truth types (in the input type for
+    // fixed-point truth values):
+    using real_type = std::conditional_t<std::is_floating_point_v<value_type>,
+                                         std::common_type_t<input_type, value_type>, input_type>;
+
+    /**
+     * \brief Wraps any function (the fallback for shapes that have no closed form here).
+     */
+    explicit fuzzy_set(function_type f)
+      : m_kind{fuzzy_set_kind::function}, m_x{}, m_y{truth_type{0}, truth_type{0}, truth_type{0}},
+        m_function{std::move(f)} {
+    }
+
+    /**
+     * \brief Flat until 'begin', straight slope from 'before' to 'after' until 'end', flat after.
+     */
+    static auto slope(input_type begin, input_type end, truth_type before, truth_type after)
+        -> fuzzy_set {
+      return fuzzy_set{fuzzy_set_kind::slope, {begin, end, end - begin, 0}, {before, after, after}};
+    }
+
+    /**
+     * \brief Flat until 'begin' (at 'before'), straight slopes to the apex at 'i_apex' (at
+     *        't_apex') and down to 'end' (at 'after'), flat after.
+     */
+    static auto triangle(input_type begin, input_type i_apex, input_type end, truth_type before,
+                         truth_type t_apex, truth_type after) -> fuzzy_set {
+      return fuzzy_set{fuzzy_set_kind::triangle, {begin, i_apex, end, 0}, {before, t_apex, after}};
+    }
+
+    /**
+     * \brief At 'floor' outside of [a, d], at 'ceil' on [b, c], with straight slopes in between.
+     */
+    static auto trapezoid(input_type a, input_type b, input_type c, input_type d, truth_type floor,
+                          truth_type ceil) -> fuzzy_set {
+      return fuzzy_set{fuzzy_set_kind::trapezoid, {a, b, c, d}, {floor, ceil, floor}};
+    }
+
+    /**
+     * \brief Bell curve centered on 'mean', going from 'floor' (far from the mean) to 'ceil' (at
+     *        the mean).
+     */
+    static auto gaussian(input_type mean, input_type sd, truth_type floor, truth_type ceil)
+        -> fuzzy_set {
+      return fuzzy_set{fuzzy_set_kind::gaussian, {mean, sd, 0, 0}, {floor, ceil, floor}};
+    }
+
+    /**
+     * \brief Crisp set: 'inside' on [begin, end), 'outside' elsewhere.
+     */
+    static auto interval(input_type begin, input_type end, truth_type outside, truth_type inside)
+        -> fuzzy_set {
+      return fuzzy_set{fuzzy_set_kind::interval, {begin, end, 0, 0}, {outside, inside, outside}};
+    }
+
+    /**
+     * \brief Samples a fuzzy set into a lookup table of 2^k entries over [a, b): the entry 'i' is
+     *        the membership at the middle of the i-th cell of width h = (b - a) / 2^k, and an input
+     *        is mapped to its cell by one multiply and a truncation (inputs outside of [a, b) use
+     *        the first or last cell).
+     *
+     * Error bound: for inputs in [a, b] and a fuzzy set that is L-Lipschitz (its slopes are at
+     * most L), the error is at most L * h / 2 = L * (b - a) / 2^(k + 1). For the partitions of
+     * make_triangles(n, a, b, ...), L = (n - 1) / (b - a) so the error is at most
+     * (n - 1) / 2^(k + 1) (e.g. 0.0005 for n = 5 and k = 12). Discontinuous sets (intervals) are
+     * exact except in the cells containing a discontinuity.
+     */
+    static auto tabulate(fuzzy_set const& f, size_t k, input_type a, input_type b) -> fuzzy_set;
+
+    /**
+     * \brief Shape of the fuzzy set.
+     */
+    auto kind() const -> fuzzy_set_kind {
+      return m_kind;
+    }
+
+    /**
+     * \brief Membership degree of 'x'.
+     */
+    auto operator()(input_type x) const -> truth_type {
+      switch (m_kind) {
+        case fuzzy_set_kind::slope:
+          return eval_slope(x);
+        case fuzzy_set_kind::triangle:
+          return eval_triangle(x);
+        case fuzzy_set_kind::trapezoid:
+          return eval_trapezoid(x);
+        case fuzzy_set_kind::gaussian:
+          return eval_gaussian(x);
+        case fuzzy_set_kind::interval:
+          return eval_interval(x);
+        case fuzzy_set_kind::table:
+          return eval_table(x);
+        default: // case fuzzy_set_kind::function:
+          return m_function(x);
+      }
+    }
+
+    /**
+     * \brief Membership degrees of the 'n' inputs 'xs', written to 'out'. The shape is dispatched
+     *        once for the whole array.
+     */
+    auto operator()(input_type const* xs, size_t n, truth_type* out) const -> void;
+
+   private:
+    fuzzy_set(fuzzy_set_kind k, std::array<input_type, 4> const& x,
+              std::array<truth_type, 3> const& y)
+      : m_kind{k}, m_x(x), m_y(y) {
+    }
+
+    /**
+     * \brief The ith truth value of the shape as a real number.
+     */
+    auto y(size_t i) const -> real_type {
+      return real_type(m_y[i].value);
+    }
+
+    /**
+     * \brief Converts a degree computed as a real number.
+     */
+    static auto degree(real_type d) -> truth_type {
+      return truth_type{value_type(d)};
+    }
+
+    auto eval_slope(double x) const -> truth_type {
+      if (x < m_x[0]) {
+        return m_y[0];
+      }
+      if (x < m_x[1]) {
+        return degree(y(0) * (1 - (x - m_x[0]) / m_x[2]) + y(1) * (1 - (m_x[1] - x) / m_x[2]));
+      }
+      return m_y[1];
+    }
+
+    auto eval_triangle(input_type x) const -> truth_type {
+      if (x < m_x[0]) {
+        return m_y[0];
+      }
+      if (x < m_x[1]) {
+        auto const length = m_x[1] - m_x[0];
+        return degree(y(0) * (1 - (x - m_x[0]) / length) + y(1) * (1 - (m_x[1] - x) / length));
+      }
+      if (x < m_x[2]) {
+        auto const length = m_x[2] - m_x[1];
+        return degree(y(1) * (1 - (x - m_x[1]) / length) + y(2) * (1 - (m_x[2] - x) / length));
+      }
+      return m_y[2];
+    }
+
+    auto eval_trapezoid(input_type x) const -> truth_type {
+      if (x < m_x[0] || !(x < m_x[3])) {
+        return m_y[0];
+      }
+      if (x < m_x[1]) {
+        return degree(y(0) + (y(1) - y(0)) * (x - m_x[0]) / (m_x[1] - m_x[0]));
+      }
+      if (x < m_x[2]) {
+        return m_y[1];
+      }
+      return degree(y(0) + (y(1) - y(0)) * (m_x[3] - x) / (m_x[3] - m_x[2]));
+    }
+
+    auto eval_gaussian(input_type x) const -> truth_type {
+      auto const z = (x - m_x[0]) / m_x[1];
+      return degree(y(0) + (y(1) - y(0)) * std::exp(-z * z / 2));
+    }
+
+    auto eval_interval(input_type x) const -> truth_type {
+      return m_x[0] <= x && x < m_x[1]? m_y[1] : m_y[0];
+    }
+
+    auto eval_table(input_type x) const -> truth_type {
+      auto const t = (x - m_x[0]) * m_x[1];
+      auto const c = t > input_type(0)? std::min(t, m_x[2]) : input_type(0); // NaN goes to 0.
+      return (*m_table)[size_t(c)];
+    }
+
+    fuzzy_set_kind m_kind;
+    std::array<input_type, 4> m_x; // Breakpoints on the input axis (depend on the shape).
+    std::array<truth_type, 3> m_y; // Truth values of the flat parts (or apex) of the shape.
+    function_type m_function; // Only for fuzzy_set_kind::function.
+    std::shared_ptr<vector<truth_type> const> m_table; // Only for fuzzy_set_kind::table.
+  };
+
+  template<typename Input, typename Truth>
+  auto fuzzy_set<Input, Truth>::tabulate(fuzzy_set const& f, size_t k, input_type a, input_type b)
+      -> fuzzy_set {
+    auto const size = size_t{1} << k;
+    auto const h = (b - a) / input_type(size);
+    auto table = vector<truth_type>{};
+    table.reserve(size);
+    for (auto i = size_t{0}; i < size; ++i) {
+      table.push_back(f(a + (input_type(i) + input_type(0.5)) * h));
+    }
+    auto t = fuzzy_set{fuzzy_set_kind::table, {a, input_type(size) / (b - a), input_type(size - 1), 0},
+                       {truth_type{0}, truth_type{0}, truth_type{0}}};
+    t.m_table = std::make_shared<vector<truth_type> const>(std::move(table));
+    return t;
+  }
+
+  template<typename Input, typename Truth>
+  auto fuzzy_set<Input, Truth>::operator()(input_type const* xs, size_t n, truth_type* out) const
+      -> void {
+    switch (m_kind) {
+      case fuzzy_set_kind::slope:
+        for (auto i = size_t{0}; i < n; ++i) {
+          out[i] = eval_slope(xs[i]);
+        }
+        break;
+      case fuzzy_set_kind::triangle:
+        for (auto i = size_t{0}; i < n; ++i) {
+          out[i] = eval_triangle(xs[i]);
+        }
+        break;
+      case fuzzy_set_kind::trapezoid:
+        for (auto i = size_t{0}; i < n; ++i) {
+          out[i] = eval_trapezoid(xs[i]);
+        }
+        break;
+      case fuzzy_set_kind::gaussian:
+        for (auto i = size_t{0}; i < n; ++i) {
+          out[i] = eval_gaussian(xs[i]);
+        }
+        break;
+      case fuzzy_set_kind::interval:
+        for (auto i = size_t{0}; i < n; ++i) {
+          out[i] = eval_interval(xs[i]);
+        }
+        break;
+      case fuzzy_set_kind::table:
+        for (auto i = size_t{0}; i < n; ++i) {
+          out[i] = eval_table(xs[i]);
+        }
+        break;
+      default: // case fuzzy_set_kind::function:
+        for (auto i = size_t{0}; i < n; ++i) {
+          out[i] = m_function(xs[i]);
+        }
+    }
+  }
+
   /**
    * \brief Builds a piecewise function that starts flat, has a straight slope, and continues flat.
    *
@@ -60,17 +332,8 @@ namespace cj {
    * \return          A function f: Input -> Truth representing the slope.
    */
   template<typename Input, typename Truth>
-  auto make_slope(Input begin, Input end, Truth before, Truth after) -> std::function<Truth(Input)> {
-    auto const length = end - begin;
-    return [=](double x) {
-      if (x < begin) {
-        return before;
-      }
-      if (x < end) {
-        return Truth{before.value * (1 - (x - begin) / length) + after.value * (1 - (end - x) / length)};
-      }
-      return after;
-    };
+  auto make_slope(Input begin, Input end, Truth before, Truth after) -> fuzzy_set<Input, Truth> {
+    return fuzzy_set<Input, Truth>::slope(begin, end, before, after);
   }
 
   /**
@@ -85,21 +348,8 @@ namespace cj {
    * \return          A function f: double -> double representing the triangles.
    */
   template<typename Input, typename Truth>
-  auto make_triangle(Input begin, Input i_apex, Input end, Truth before, Truth t_apex, Truth after) -> std::function<Truth(Input)> {
-    auto const ls_length = i_apex - begin;
-    auto const rs_length = end - i_apex;
-    return [=](Input x) {
-      if (x < begin) {
-        return before;
-      }
-      if (x < i_apex) {
-        return Truth{before.value * (1 - (x - begin) / ls_length) + t_apex.value * (1 - (i_apex - x) / ls_length)};
-      }
-      if (x < end) {
-        return Truth{t_apex.value * (1 - (x - i_apex) / rs_length) + after.value * (1 - (end - x) / rs_length)};
-      }
-      return after;
-    };
+  auto make_triangle(Input begin, Input i_apex, Input end, Truth before, Truth t_apex, Truth after) -> fuzzy_set<Input, Truth> {
+    return fuzzy_set<Input, Truth>::triangle(begin, i_apex, end, before, t_apex, after);
   }
 
   /**
@@ -113,8 +363,8 @@ namespace cj {
    * \return         Vector of triangles.
    */
   template<typename Input, typename Truth>
-  auto make_triangles(size_t n, Input begin, Input end, Truth floor, Truth ceil) noexcept -> vector<std::function<Truth(Input)>> {
-    auto triangles = vector<std::function<Truth(Input)>>{};
+  auto make_triangles(size_t n, Input begin, Input end, Truth floor, Truth ceil) noexcept -> vector<fuzzy_set<Input, Truth>> {
+    auto triangles = vector<fuzzy_set<Input, Truth>>{};
     if (n < 2) {
       return triangles;
     }
@@ -127,6 +377,68 @@ namespace cj {
     return triangles;
   }
 
+  /**
+   * \brief Creates 'n' equal-sized trapezoids from 'a' to 'b': the flat top of each covers
+   *        'plateau' (in [0, 1)) of the distance between two consecutive centers, the first and
+   *        last ones extending to -infinity and infinity.
+   */
+  template<typename Input, typename Truth>
+  auto make_trapezoids(size_t n, Input begin, Input end, double plateau, Truth floor, Truth ceil) -> vector<fuzzy_set<Input, Truth>> {
+    auto trapezoids = vector<fuzzy_set<Input, Truth>>{};
+    if (n < 2) {
+      return trapezoids;
+    }
+    auto const inf = std::numeric_limits<Input>::infinity();
+    double const step = (end - begin) / (n - 1);
+    double const half_top = plateau * step / 2;
+    for (auto i = 0u; i < n; ++i) {
+      auto const center = begin + i * step;
+      trapezoids.push_back(fuzzy_set<Input, Truth>::trapezoid(
+        i == 0? -inf : Input(center - step + half_top), i == 0? -inf : Input(center - half_top),
+        i == n - 1? inf : Input(center + half_top), i == n - 1? inf : Input(center + step - half_top),
+        floor, ceil));
+    }
+    return trapezoids;
+  }
+
+  /**
+   * \brief Creates 'n' Gaussian fuzzy sets with centers equally spaced from 'a' to 'b', each
+   *        crossing its neighbors at half height.
+   */
+  template<typename Input, typename Truth>
+  auto make_gaussians(size_t n, Input begin, Input end, Truth floor, Truth ceil) -> vector<fuzzy_set<Input, Truth>> {
+    auto gaussians = vector<fuzzy_set<Input, Truth>>{};
+    if (n < 2) {
+      return gaussians;
+    }
+    double const step = (end - begin) / (n - 1);
+    auto const sd = Input(step / (2 * std::sqrt(2 * std::log(2.0))));
+    for (auto i = 0u; i < n; ++i) {
+      gaussians.push_back(fuzzy_set<Input, Truth>::gaussian(Input(begin + i * step), sd, floor, ceil));
+    }
+    return gaussians;
+  }
+
+  /**
+   * \brief Splits [a, b) into 'n' equal-sized crisp intervals, the first and last ones extending
+   *        to -infinity and infinity.
+   */
+  template<typename Input, typename Truth>
+  auto make_intervals(size_t n, Input begin, Input end, Truth floor, Truth ceil) -> vector<fuzzy_set<Input, Truth>> {
+    auto intervals = vector<fuzzy_set<Input, Truth>>{};
+    if (n < 2) {
+      return intervals;
+    }
+    auto const inf = std::numeric_limits<Input>::infinity();
+    double const step = (end - begin) / n;
+    for (auto i = 0u; i < n; ++i) {
+      intervals.push_back(fuzzy_set<Input, Truth>::interval(
+        i == 0? -inf : Input(begin + i * step), i == n - 1? inf : Input(begin + (i + 1) * step),
+        floor, ceil));
+    }
+    return intervals;
+  }
+
 } /* end namespace cj */
 
 #endif
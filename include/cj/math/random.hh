@@ -9,6 +9,25 @@
 
 namespace cj {
 
+  /**
+   * \brief The finalizer of the splitmix64 generator: a fast bijective mixing of 64-bit integers,
+   *        used to derive seeds and hash keys from small integers.
+   */
+  constexpr auto splitmix64(uint64_t x) noexcept -> uint64_t {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  /**
+   * \brief Derives the seed of an independent random stream from a seed and two integers (e.g.
+   *        a generation and an index in a population).
+   */
+  constexpr auto derive_seed(uint64_t seed, uint64_t a, uint64_t b) noexcept -> uint64_t {
+    return splitmix64(splitmix64(splitmix64(seed) ^ a) ^ b);
+  }
+
   /**
    * \brief Generates n unique integers within a range (not including 'end'). If the range is smaller
    *        than n, return the entire range.
@@ -30,6 +49,24 @@ namespace cj {
     return u;
   }
 
+  /**
+   * \brief Draws n distinct indices in [0, range) in increasing order, in one pass over the range
+   *        (selection sampling). If the range is smaller than n, returns the entire range.
+   */
+  template<typename Rng>
+  auto sample_indices(size_t n, size_t range, Rng& rng) -> vector<size_t> {
+    n = std::min(n, range);
+    auto indices = vector<size_t>{};
+    indices.reserve(n);
+    auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+    for (auto i = size_t{0}; i < range && indices.size() < n; ++i) {
+      if (double(range - i) * unif(rng) < double(n - indices.size())) {
+        indices.push_back(i);
+      }
+    }
+    return indices;
+  }
+
   /**
    * \brief Pick two distinct elements from a container.
    */
@@ -0,0 +1,330 @@
+/**
+ * \file   truth_kernels.hh
+ * \brief  Conjunctions and disjunctions over contiguous arrays of truth values.
+ */
+#ifndef CJ_TRUTH_KERNELS_HH_
+#define CJ_TRUTH_KERNELS_HH_
+
+#include <type_traits>
+#if defined(__SSE2__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+#include "cj/common.hh"
+#include "cj/math/truth.hh"
+
+namespace cj {
+
+  /**
+   * \brief Reference implementations of the kernels: plain loops over the scalar operators of
+   *        truth.hh. The kernels of the 'cj' namespace give the same values for all logics.
+   */
+  namespace scalar {
+
+    /**
+     * \brief out[i] = a[i] && b[i] ('out' may be 'a' or 'b').
+     */
+    template<typename Truth>
+    auto conjoin(Truth const* a, Truth const* b, Truth* out, size_t n) -> void {
+      for (auto i = size_t{0}; i < n; ++i) {
+        out[i] = a[i] && b[i];
+      }
+    }
+
+    /**
+     * \brief out[i] = a[i] || b[i] ('out' may be 'a' or 'b').
+     */
+    template<typename Truth>
+    auto disjoin(Truth const* a, Truth const* b, Truth* out, size_t n) -> void {
+      for (auto i = size_t{0}; i < n; ++i) {
+        out[i] = a[i] || b[i];
+      }
+    }
+
+    /**
+     * \brief out[i] = xs[0][i] && xs[1][i] && ... && xs[k - 1][i], from left to right (the unit
+     *        for k = 0).
+     */
+    template<typename Truth>
+    auto conjoin_all(Truth const* const* xs, size_t k, Truth* out, size_t n) -> void {
+      for (auto i = size_t{0}; i < n; ++i) {
+        auto t = k == 0? Truth{1} : xs[0][i];
+        for (auto j = size_t{1}; j < k; ++j) {
+          t = t && xs[j][i];
+        }
+        out[i] = t;
+      }
+    }
+
+    /**
+     * \brief out[i] = xs[0][i] || xs[1][i] || ... || xs[k - 1][i], from left to right (zero for
+     *        k = 0).
+     */
+    template<typename Truth>
+    auto disjoin_all(Truth const* const* xs, size_t k, Truth* out, size_t n) -> void {
+      for (auto i = size_t{0}; i < n; ++i) {
+        auto t = k == 0? Truth{0} : xs[0][i];
+        for (auto j = size_t{1}; j < k; ++j) {
+          t = t || xs[j][i];
+        }
+        out[i] = t;
+      }
+    }
+
+    /**
+     * \brief acc[i] = acc[i] || (a[i] && b[i]), without storing the conjunctions.
+     */
+    template<typename Truth>
+    auto conjoin_disjoin(Truth* acc, Truth const* a, Truth const* b, size_t n) -> void {
+      for (auto i = size_t{0}; i < n; ++i) {
+        acc[i] = acc[i] || (a[i] && b[i]);
+      }
+    }
+
+  } /* end namespace scalar */
+
+  namespace detail {
+
+    /**
+     * \brief Registers of the widest instruction set enabled at compile time (AVX, then SSE2),
+     *        'width' being 0 when there is none for 'F'.
+     */
+    template<typename F>
+    struct simd {
+      static constexpr size_t width = 0;
+    };
+
+#if defined(__AVX__)
+    template<>
+    struct simd<double> {
+      using reg = __m256d;
+      static constexpr size_t width = 4;
+      static auto load(double const* p) -> reg { return _mm256_loadu_pd(p); }
+      static auto store(double* p, reg r) -> void { _mm256_storeu_pd(p, r); }
+      static auto set1(double x) -> reg { return _mm256_set1_pd(x); }
+      static auto add(reg a, reg b) -> reg { return _mm256_add_pd(a, b); }
+      static auto sub(reg a, reg b) -> reg { return _mm256_sub_pd(a, b); }
+      static auto mul(reg a, reg b) -> reg { return _mm256_mul_pd(a, b); }
+      static auto min(reg a, reg b) -> reg { return _mm256_min_pd(a, b); }
+      static auto max(reg a, reg b) -> reg { return _mm256_max_pd(a, b); }
+    };
+
+    template<>
+    struct simd<float> {
+      using reg = __m256;
+      static constexpr size_t width = 8;
+      static auto load(float const* p) -> reg { return _mm256_loadu_ps(p); }
+      static auto store(float* p, reg r) -> void { _mm256_storeu_ps(p, r); }
+      static auto set1(float x) -> reg { return _mm256_set1_ps(x); }
+      static auto add(reg a, reg b) -> reg { return _mm256_add_ps(a, b); }
+      static auto sub(reg a, reg b) -> reg { return _mm256_sub_ps(a, b); }
+      static auto mul(reg a, reg b) -> reg { return _mm256_mul_ps(a, b); }
+      static auto min(reg a, reg b) -> reg { return _mm256_min_ps(a, b); }
+      static auto max(reg a, reg b) -> reg { return _mm256_max_ps(a, b); }
+    };
+#elif defined(__SSE2__)
+    template<>
+    struct simd<double> {
+      using reg = __m128d;
+      static constexpr size_t width = 2;
+      static auto load(double const* p) -> reg { return _mm_loadu_pd(p); }
+      static auto store(double* p, reg r) -> void { _mm_storeu_pd(p, r); }
+      static auto set1(double x) -> reg { return _mm_set1_pd(x); }
+      static auto add(reg a, reg b) -> reg { return _mm_add_pd(a, b); }
+      static auto sub(reg a, reg b) -> reg { return _mm_sub_pd(a, b); }
+      static auto mul(reg a, reg b) -> reg { return _mm_mul_pd(a, b); }
+      static auto min(reg a, reg b) -> reg { return _mm_min_pd(a, b); }
+      static auto max(reg a, reg b) -> reg { return _mm_max_pd(a, b); }
+    };
+
+    template<>
+    struct simd<float> {
+      using reg = __m128;
+      static constexpr size_t width = 4;
+      static auto load(float const* p) -> reg { return _mm_loadu_ps(p); }
+      static auto store(float* p, reg r) -> void { _mm_storeu_ps(p, r); }
+      static auto set1(float x) -> reg { return _mm_set1_ps(x); }
+      static auto add(reg a, reg b) -> reg { return _mm_add_ps(a, b); }
+      static auto sub(reg a, reg b) -> reg { return _mm_sub_ps(a, b); }
+      static auto mul(reg a, reg b) -> reg { return _mm_mul_ps(a, b); }
+      static auto min(reg a, reg b) -> reg { return _mm_min_ps(a, b); }
+      static auto max(reg a, reg b) -> reg { return _mm_max_ps(a, b); }
+    };
+#endif
+
+    /**
+     * \brief The operators of a logic on registers. They follow the operations of the scalar
+     *        operators in the same order, and min(a, b) / max(a, b) pick 'b' unless 'a' is
+     *        strictly smaller / greater (as std::min(b, a) / std::max(b, a)), so the results are
+     *        the same bit for bit.
+     */
+    template<typename Truth, typename = void>
+    struct simd_logic {
+      static constexpr bool enabled = false;
+    };
+
+    template<typename F>
+    struct simd_logic<lukasiewicz<F>, std::enable_if_t<(simd<F>::width > 0)>> {
+      using simd_type = simd<F>;
+      using reg = typename simd_type::reg;
+      static constexpr bool enabled = true;
+      static auto conj(reg a, reg b) -> reg {
+        return simd_type::max(simd_type::sub(simd_type::add(a, b), simd_type::set1(F(1))),
+                              simd_type::set1(F(0)));
+      }
+      static auto disj(reg a, reg b) -> reg {
+        return simd_type::min(simd_type::add(a, b), simd_type::set1(F(1)));
+      }
+    };
+
+    template<typename F>
+    struct simd_logic<godel<F>, std::enable_if_t<(simd<F>::width > 0)>> {
+      using simd_type = simd<F>;
+      using reg = typename simd_type::reg;
+      static constexpr bool enabled = true;
+      static auto conj(reg a, reg b) -> reg { return simd_type::min(b, a); }
+      static auto disj(reg a, reg b) -> reg { return simd_type::max(b, a); }
+    };
+
+    template<typename F>
+    struct simd_logic<product<F>, std::enable_if_t<(simd<F>::width > 0)>> {
+      using simd_type = simd<F>;
+      using reg = typename simd_type::reg;
+      static constexpr bool enabled = true;
+      static auto conj(reg a, reg b) -> reg { return simd_type::mul(a, b); }
+      static auto disj(reg a, reg b) -> reg {
+        return simd_type::sub(simd_type::add(a, b), simd_type::mul(a, b));
+      }
+    };
+
+    template<typename Truth>
+    auto values(Truth const* p) -> typename Truth::value_type const* {
+      static_assert(sizeof(Truth) == sizeof(typename Truth::value_type));
+      return reinterpret_cast<typename Truth::value_type const*>(p);
+    }
+
+    template<typename Truth>
+    auto values(Truth* p) -> typename Truth::value_type* {
+      static_assert(sizeof(Truth) == sizeof(typename Truth::value_type));
+      return reinterpret_cast<typename Truth::value_type*>(p);
+    }
+
+  } /* end namespace detail */
+
+  /**
+   * \brief out[i] = a[i] && b[i] ('out' may be 'a' or 'b').
+   */
+  template<typename Truth>
+  auto conjoin(Truth const* a, Truth const* b, Truth* out, size_t n) -> void {
+    auto i = size_t{0};
+    if constexpr (detail::simd_logic<Truth>::enabled) {
+      using logic = detail::simd_logic<Truth>;
+      using simd_type = typename logic::simd_type;
+      auto const* const va = detail::values(a);
+      auto const* const vb = detail::values(b);
+      auto* const vo = detail::values(out);
+      for (; i + simd_type::width <= n; i += simd_type::width) {
+        simd_type::store(vo + i, logic::conj(simd_type::load(va + i), simd_type::load(vb + i)));
+      }
+    }
+    scalar::conjoin(a + i, b + i, out + i, n - i);
+  }
+
+  /**
+   * \brief out[i] = a[i] || b[i] ('out' may be 'a' or 'b').
+   */
+  template<typename Truth>
+  auto disjoin(Truth const* a, Truth const* b, Truth* out, size_t n) -> void {
+    auto i = size_t{0};
+    if constexpr (detail::simd_logic<Truth>::enabled) {
+      using logic = detail::simd_logic<Truth>;
+      using simd_type = typename logic::simd_type;
+      auto const* const va = detail::values(a);
+      auto const* const vb = detail::values(b);
+      auto* const vo = detail::values(out);
+      for (; i + simd_type::width <= n; i += simd_type::width) {
+        simd_type::store(vo + i, logic::disj(simd_type::load(va + i), simd_type::load(vb + i)));
+      }
+    }
+    scalar::disjoin(a + i, b + i, out + i, n - i);
+  }
+
+  /**
+   * \brief out[i] = xs[0][i] && xs[1][i] && ... && xs[k - 1][i], from left to right (the unit for
+   *        k = 0). The partial conjunctions stay in registers.
+   */
+  template<typename Truth>
+  auto conjoin_all(Truth const* const* xs, size_t k, Truth* out, size_t n) -> void {
+    auto i = size_t{0};
+    if constexpr (detail::simd_logic<Truth>::enabled) {
+      using logic = detail::simd_logic<Truth>;
+      using simd_type = typename logic::simd_type;
+      auto* const vo = detail::values(out);
+      for (; k > 0 && i + simd_type::width <= n; i += simd_type::width) {
+        auto t = simd_type::load(detail::values(xs[0]) + i);
+        for (auto j = size_t{1}; j < k; ++j) {
+          t = logic::conj(t, simd_type::load(detail::values(xs[j]) + i));
+        }
+        simd_type::store(vo + i, t);
+      }
+    }
+    for (; i < n; ++i) {
+      auto t = k == 0? Truth{1} : xs[0][i];
+      for (auto j = size_t{1}; j < k; ++j) {
+        t = t && xs[j][i];
+      }
+      out[i] = t;
+    }
+  }
+
+  /**
+   * \brief out[i] = xs[0][i] || xs[1][i] || ... || xs[k - 1][i], from left to right (zero for
+   *        k = 0). The partial disjunctions stay in registers.
+   */
+  template<typename Truth>
+  auto disjoin_all(Truth const* const* xs, size_t k, Truth* out, size_t n) -> void {
+    auto i = size_t{0};
+    if constexpr (detail::simd_logic<Truth>::enabled) {
+      using logic = detail::simd_logic<Truth>;
+      using simd_type = typename logic::simd_type;
+      auto* const vo = detail::values(out);
+      for (; k > 0 && i + simd_type::width <= n; i += simd_type::width) {
+        auto t = simd_type::load(detail::values(xs[0]) + i);
+        for (auto j = size_t{1}; j < k; ++j) {
+          t = logic::disj(t, simd_type::load(detail::values(xs[j]) + i));
+        }
+        simd_type::store(vo + i, t);
+      }
+    }
+    for (; i < n; ++i) {
+      auto t = k == 0? Truth{0} : xs[0][i];
+      for (auto j = size_t{1}; j < k; ++j) {
+        t = t || xs[j][i];
+      }
+      out[i] = t;
+    }
+  }
+
+  /**
+   * \brief acc[i] = acc[i] || (a[i] && b[i]), without storing the conjunctions (e.g. the last
+   *        literal of a rule and the disjunction into its class).
+   */
+  template<typename Truth>
+  auto conjoin_disjoin(Truth* acc, Truth const* a, Truth const* b, size_t n) -> void {
+    auto i = size_t{0};
+    if constexpr (detail::simd_logic<Truth>::enabled) {
+      using logic = detail::simd_logic<Truth>;
+      using simd_type = typename logic::simd_type;
+      auto const* const va = detail::values(a);
+      auto const* const vb = detail::values(b);
+      auto* const vacc = detail::values(acc);
+      for (; i + simd_type::width <= n; i += simd_type::width) {
+        auto const c = logic::conj(simd_type::load(va + i), simd_type::load(vb + i));
+        simd_type::store(vacc + i, logic::disj(simd_type::load(vacc + i), c));
+      }
+    }
+    scalar::conjoin_disjoin(acc + i, a + i, b + i, n - i);
+  }
+
+} /* end namespace cj */
+
+#endif
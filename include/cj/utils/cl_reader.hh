@@ -6,6 +6,7 @@
 #define CJ_CL_READER_HH_
 
 #include "cj/common.hh"
+#include "cj/utils/string.hh"
 #include "cj/utils/detail/match_arg.hh"
 
 namespace cj {
@@ -53,6 +54,33 @@ namespace cj {
     return res.first == -1? def : boost::lexical_cast<T>(res.second);
   }
 
+  /**
+   * \brief Gets the comma-separated values of a command-line option or default values if not found.
+   *
+   * For example, given "--foo=3,5,7", this function will return {3, 5, 7} for
+   * get_arg<uint32_t>(argc, argv, "foo", {5}).
+   *
+   * \param argc   Number of command-line arguments.
+   * \param argv   The command-line arguments.
+   * \param opt    The option.
+   * \param def    Default values if argument not found.
+   * \return       Values for the option.
+   */
+  template<typename T>
+  auto get_arg(int argc, char** argv, char const* opt, vector<T> const& def) -> vector<T> {
+    auto const res = match_arg(argc, argv, opt);
+    if (res.first == -1) {
+      return def;
+    }
+    auto values = vector<T>{};
+    for (auto const& tk : split(res.second, ',')) {
+      if (!tk.empty()) {
+        values.push_back(boost::lexical_cast<T>(tk));
+      }
+    }
+    return values;
+  }
+
 } /* end namespace cj */
 
 #endif
@@ -0,0 +1,124 @@
+/**
+ * \brief A map with a maximum number of elements that evicts the least recently used element to
+ *        make place for new ones. Use case: memoize the fitness of the classifiers in an
+ *        evolutionary algorithm.
+ */
+#ifndef CJ_LRU_CACHE_HH_
+#define CJ_LRU_CACHE_HH_
+
+#include <list>
+#include "cj/common.hh"
+
+namespace cj {
+
+  /**
+   * \brief A map that accepts only a fixed number of elements. Will remove the least recently
+   *        used (inserted or found) element when inserting in a full container.
+   */
+  template<typename Key, typename T, typename Hash = std::hash<Key>>
+  class lru_cache {
+   public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = pair<const key_type, mapped_type>;
+    using list_type = std::list<value_type>;
+    using const_iterator = typename list_type::const_iterator;
+
+    /**
+     * \brief Creates a cache by setting its maximum number of elements.
+     */
+    lru_cache(size_t max_size) : m_max_size{max_size} {};
+
+    /**
+     * \brief Whether the container is empty.
+     */
+    auto empty() const -> bool {
+      return m_values.empty();
+    }
+
+    /**
+     * \brief Current number of elements.
+     */
+    auto size() const -> size_t {
+      return m_index.size();
+    }
+
+    /**
+     * \brief Maximum tolerated number of elements.
+     */
+    auto max_size() const -> size_t {
+      return m_max_size;
+    }
+
+    /**
+     * \brief Removes all elements from the container.
+     */
+    auto clear() -> void {
+      m_index.clear();
+      m_values.clear();
+    }
+
+    /**
+     * \brief Returns a pointer to the element mapped to 'k' (nullptr if there is none) and marks
+     *        it as the most recently used.
+     */
+    auto find(key_type const& k) -> mapped_type*;
+
+    /**
+     * \brief Inserts or replaces the element mapped to 'k', removing the least recently used
+     *        element if the container is full. Does nothing if max_size() is 0.
+     */
+    auto insert(key_type const& k, mapped_type const& m) -> void;
+
+    /**
+     * \brief Iterator to the most recently used element.
+     */
+    auto begin() const -> const_iterator {
+      return m_values.begin();
+    }
+
+    /**
+     * \brief End of the iterator from most recently to least recently used elements.
+     */
+    auto end() const -> const_iterator {
+      return m_values.end();
+    }
+
+   private:
+    list_type m_values; // From most recently used to least recently used.
+    std::unordered_map<key_type, typename list_type::iterator, Hash> m_index;
+    size_t m_max_size;
+  };
+
+  template<typename K, typename T, typename H>
+  auto lru_cache<K, T, H>::find(key_type const& k) -> mapped_type* {
+    auto it = m_index.find(k);
+    if (it == m_index.end()) {
+      return nullptr;
+    }
+    m_values.splice(m_values.begin(), m_values, it->second);
+    return &it->second->second;
+  }
+
+  template<typename K, typename T, typename H>
+  auto lru_cache<K, T, H>::insert(key_type const& k, mapped_type const& m) -> void {
+    if (m_max_size == 0) {
+      return;
+    }
+    auto it = m_index.find(k);
+    if (it != m_index.end()) {
+      it->second->second = m;
+      m_values.splice(m_values.begin(), m_values, it->second);
+      return;
+    }
+    if (m_index.size() == m_max_size) {
+      m_index.erase(m_values.back().first);
+      m_values.pop_back();
+    }
+    m_values.emplace_front(k, m);
+    m_index.emplace(k, m_values.begin());
+  }
+
+} /* end namespace cj */
+
+#endif
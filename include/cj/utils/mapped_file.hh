@@ -0,0 +1,136 @@
+/**
+ * \file   mapped_file.hh
+ * \brief  Read-only memory mapping of a file.
+ */
+#ifndef CJ_UTILS_MAPPED_FILE_HH_
+#define CJ_UTILS_MAPPED_FILE_HH_
+
+#include "cj/common.hh"
+#if defined(_WIN32)
+# include "cj/utils/string.hh"
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace cj {
+
+  /**
+   * \brief The contents of a file mapped in memory (read-only) for as long as the object lives.
+   *        Where mmap is not available, the file is read into memory instead.
+   */
+  class mapped_file {
+   public:
+    /**
+     * \brief Maps a file, or returns std::nullopt if it cannot be opened.
+     */
+    static auto open(char const* filename) -> std::optional<mapped_file>;
+
+    mapped_file(mapped_file const&) = delete;
+    auto operator=(mapped_file const&) -> mapped_file& = delete;
+
+    mapped_file(mapped_file&& other) noexcept
+      : m_data{other.m_data}, m_size{other.m_size}, m_mapped{other.m_mapped},
+        m_contents{std::move(other.m_contents)} {
+      other.m_data = nullptr;
+      other.m_size = 0;
+      other.m_mapped = false;
+      if (!m_mapped) {
+        m_data = m_contents.data();
+      }
+    }
+
+    auto operator=(mapped_file&& other) noexcept -> mapped_file& {
+      if (this != &other) {
+        unmap();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_mapped = other.m_mapped;
+        m_contents = std::move(other.m_contents);
+        if (!m_mapped) {
+          m_data = m_contents.data();
+        }
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_mapped = false;
+      }
+      return *this;
+    }
+
+    ~mapped_file() {
+      unmap();
+    }
+
+    /**
+     * \brief First byte of the file.
+     */
+    auto data() const noexcept -> char const* {
+      return m_data;
+    }
+
+    /**
+     * \brief Size of the file in bytes.
+     */
+    auto size() const noexcept -> size_t {
+      return m_size;
+    }
+
+   private:
+    mapped_file() = default;
+
+    auto unmap() noexcept -> void {
+#if !defined(_WIN32)
+      if (m_mapped) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+        m_mapped = false;
+      }
+#endif
+    }
+
+    char const* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false; // Whether 'm_data' is mapped (otherwise it points in 'm_contents').
+    string m_contents;
+  };
+
+  inline auto mapped_file::open(char const* filename) -> std::optional<mapped_file> {
+    auto f = mapped_file{};
+#if defined(_WIN32)
+    auto contents = read_file(filename);
+    if (!contents) {
+      return std::nullopt;
+    }
+    f.m_contents = std::move(*contents);
+    f.m_data = f.m_contents.data();
+    f.m_size = f.m_contents.size();
+#else
+    auto const fd = ::open(filename, O_RDONLY);
+    if (fd < 0) {
+      return std::nullopt;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      return std::nullopt;
+    }
+    f.m_size = size_t(st.st_size);
+    if (f.m_size > 0) {
+      auto const p = ::mmap(nullptr, f.m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED) {
+        ::close(fd);
+        return std::nullopt;
+      }
+      ::madvise(p, f.m_size, MADV_SEQUENTIAL);
+      f.m_data = static_cast<char const*>(p);
+      f.m_mapped = true;
+    }
+    ::close(fd);
+#endif
+    return std::optional<mapped_file>{std::move(f)};
+  }
+
+} /* end namespace cj */
+
+#endif
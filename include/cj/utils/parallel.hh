@@ -0,0 +1,205 @@
+/**
+ * \file   parallel.hh
+ * \brief  Helpers to run loops on several threads.
+ */
+#ifndef CJ_UTILS_PARALLEL_HH_
+#define CJ_UTILS_PARALLEL_HH_
+
+#include <thread>
+#include <exception>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <atomic>
+#include "cj/common.hh"
+
+namespace cj {
+
+  /**
+   * \brief Calls f(i) for i in [0, n), splitting the range in contiguous chunks over 'threads'
+   *        threads (the calling thread takes the first chunk). With threads <= 1 the loop runs on
+   *        the calling thread. The first exception thrown by 'f' is rethrown once all threads are
+   *        done.
+   *
+   * \param n         Number of iterations.
+   * \param threads   Maximum number of threads to use.
+   * \param f         Function called with each index, must be safe to call concurrently.
+   */
+  template<typename F>
+  auto parallel_for(size_t n, size_t threads, F const& f) -> void {
+    threads = std::min(threads, n);
+    if (threads <= 1) {
+      for (auto i = size_t{0}; i < n; ++i) {
+        f(i);
+      }
+      return;
+    }
+    auto errors = vector<std::exception_ptr>(threads);
+    auto const run = [&](size_t k) {
+      try {
+        for (auto i = k * n / threads; i < (k + 1) * n / threads; ++i) {
+          f(i);
+        }
+      } catch (...) {
+        errors[k] = std::current_exception();
+      }
+    };
+    auto workers = vector<std::thread>{};
+    workers.reserve(threads - 1);
+    for (auto k = size_t{1}; k < threads; ++k) {
+      workers.emplace_back(run, k);
+    }
+    run(0);
+    for (auto& w : workers) {
+      w.join();
+    }
+    for (auto const& e : errors) {
+      if (e) {
+        std::rethrow_exception(e);
+      }
+    }
+  }
+
+  /**
+   * \brief A fixed set of worker threads running submitted tasks. Each worker owns a deque: it
+   *        takes its own tasks from the back and, once its deque is empty, steals from the front of
+   *        the other deques. Tasks submitted from a worker go to that worker's deque, others are
+   *        dealt to the workers in turn. The destructor runs every queued task before joining.
+   *
+   *        A task must not block on the future of a task queued after it: with every worker
+   *        waiting, nothing would be left to run it.
+   */
+  class task_pool {
+  public:
+    /**
+     * \brief Starts max(threads, 1) workers.
+     */
+    explicit task_pool(size_t threads) : m_queues(std::max(threads, size_t{1})) {
+      m_workers.reserve(m_queues.size());
+      for (auto k = size_t{0}; k < m_queues.size(); ++k) {
+        m_workers.emplace_back([this, k] { work(k); });
+      }
+    }
+
+    task_pool(task_pool const&) = delete;
+    auto operator=(task_pool const&) -> task_pool& = delete;
+
+    /**
+     * \brief Runs the queued tasks, then joins the workers.
+     */
+    ~task_pool() {
+      {
+        auto lock = std::lock_guard<std::mutex>{m_wake_mutex};
+        m_stop = true;
+      }
+      m_wake.notify_all();
+      for (auto& w : m_workers) {
+        w.join();
+      }
+    }
+
+    /**
+     * \brief Number of workers.
+     */
+    auto size() const noexcept -> size_t {
+      return m_workers.size();
+    }
+
+    /**
+     * \brief Queues f(), returning a future on its result (or the exception it throws).
+     */
+    template<typename F>
+    auto submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>&>> {
+      using result_type = std::invoke_result_t<std::decay_t<F>&>;
+      auto task = std::make_shared<std::packaged_task<result_type()>>(std::forward<F>(f));
+      auto result = task->get_future();
+      auto const k = current_worker() < m_queues.size()? current_worker()
+                                                        : m_next++ % m_queues.size();
+      {
+        auto lock = std::lock_guard<std::mutex>{m_queues[k].mutex};
+        m_queues[k].tasks.emplace_back([task] { (*task)(); });
+      }
+      {
+        auto lock = std::lock_guard<std::mutex>{m_wake_mutex};
+        ++m_pending;
+      }
+      m_wake.notify_one();
+      return result;
+    }
+
+  private:
+    struct task_queue {
+      std::mutex mutex;
+      std::deque<std::function<void()>> tasks;
+    };
+
+    // Index of the worker running on this thread, or -1 if the thread is not one of this pool's:
+    auto current_worker() const -> size_t {
+      return worker_pool() == this? worker_index() : size_t(-1);
+    }
+
+    static auto worker_pool() -> task_pool const*& {
+      thread_local auto pool = static_cast<task_pool const*>(nullptr);
+      return pool;
+    }
+
+    static auto worker_index() -> size_t& {
+      thread_local auto index = size_t(-1);
+      return index;
+    }
+
+    // Takes a task from the back of the worker's deque, or from the front of another deque:
+    auto try_pop(size_t k, std::function<void()>& task) -> bool {
+      for (auto j = size_t{0}; j < m_queues.size(); ++j) {
+        auto& q = m_queues[(k + j) % m_queues.size()];
+        auto lock = std::lock_guard<std::mutex>{q.mutex};
+        if (!q.tasks.empty()) {
+          if (j == 0) {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+          } else {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+          }
+          auto wake_lock = std::lock_guard<std::mutex>{m_wake_mutex};
+          --m_pending;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    auto work(size_t k) -> void {
+      worker_pool() = this;
+      worker_index() = k;
+      auto task = std::function<void()>{};
+      while (true) {
+        if (try_pop(k, task)) {
+          task();
+          task = nullptr;
+          continue;
+        }
+        auto lock = std::unique_lock<std::mutex>{m_wake_mutex};
+        m_wake.wait(lock, [this] { return m_stop || m_pending > 0; });
+        if (m_stop && m_pending == 0) {
+          return;
+        }
+      }
+    }
+
+    vector<task_queue> m_queues;
+    vector<std::thread> m_workers;
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake;
+    size_t m_pending = 0; // Tasks queued and not yet taken (guarded by m_wake_mutex).
+    bool m_stop = false;
+    std::atomic<size_t> m_next{0};
+  };
+
+} /* end namespace cj */
+
+#endif
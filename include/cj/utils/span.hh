@@ -0,0 +1,66 @@
+/**
+ * \file   span.hh
+ * \brief  Read-only view of a contiguous sequence (a subset of C++20's std::span).
+ */
+#ifndef CJ_UTILS_SPAN_HH_
+#define CJ_UTILS_SPAN_HH_
+
+#include <stdexcept>
+#include "cj/common.hh"
+
+namespace cj {
+
+  /**
+   * \brief Pointer and size of a contiguous sequence of T owned elsewhere.
+   */
+  template<typename T>
+  class span {
+   public:
+    using value_type = T;
+    using const_iterator = T const*;
+
+    constexpr span() noexcept : m_data{nullptr}, m_size{0} {
+    }
+
+    constexpr span(T const* data, size_t size) noexcept : m_data{data}, m_size{size} {
+    }
+
+    constexpr auto data() const noexcept -> T const* {
+      return m_data;
+    }
+
+    constexpr auto size() const noexcept -> size_t {
+      return m_size;
+    }
+
+    constexpr auto empty() const noexcept -> bool {
+      return m_size == 0;
+    }
+
+    constexpr auto operator[](size_t i) const -> T const& {
+      return m_data[i];
+    }
+
+    auto at(size_t i) const -> T const& {
+      if (i >= m_size) {
+        throw std::out_of_range("span::at");
+      }
+      return m_data[i];
+    }
+
+    constexpr auto begin() const noexcept -> const_iterator {
+      return m_data;
+    }
+
+    constexpr auto end() const noexcept -> const_iterator {
+      return m_data + m_size;
+    }
+
+   private:
+    T const* m_data;
+    size_t m_size;
+  };
+
+} /* end namespace cj */
+
+#endif
@@ -1,219 +1,6 @@
-mkdir s3alpha0.00005 && cd $_
+mkdir sweep && cd $_
 
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=3 --alpha=0.00005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=3 --alpha=0.00005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=3 --alpha=0.00005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s5alpha0.00005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=5 --alpha=0.00005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=5 --alpha=0.00005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=5 --alpha=0.00005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s7alpha0.00005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=7 --alpha=0.00005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=7 --alpha=0.00005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=7 --alpha=0.00005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s9alpha0.00005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=9 --alpha=0.00005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=9 --alpha=0.00005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=9 --alpha=0.00005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s11alpha0.00005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=11 --alpha=0.00005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=11 --alpha=0.00005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=11 --alpha=0.00005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s3alpha0.0005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=3 --alpha=0.0005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=3 --alpha=0.0005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=3 --alpha=0.0005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s5alpha0.0005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=5 --alpha=0.0005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=5 --alpha=0.0005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=5 --alpha=0.0005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s7alpha0.0005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=7 --alpha=0.0005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=7 --alpha=0.0005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=7 --alpha=0.0005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s9alpha0.0005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=9 --alpha=0.0005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=9 --alpha=0.0005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=9 --alpha=0.0005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s11alpha0.0005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=11 --alpha=0.0005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=11 --alpha=0.0005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=11 --alpha=0.0005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s3alpha0.005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=3 --alpha=0.005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=3 --alpha=0.005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=3 --alpha=0.005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s5alpha0.005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=5 --alpha=0.005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=5 --alpha=0.005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=5 --alpha=0.005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s7alpha0.005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=7 --alpha=0.005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=7 --alpha=0.005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=7 --alpha=0.005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s9alpha0.005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=9 --alpha=0.005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=9 --alpha=0.005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=9 --alpha=0.005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s11alpha0.005 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=11 --alpha=0.005 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=11 --alpha=0.005 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=11 --alpha=0.005 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s3alpha0.05 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=3 --alpha=0.05 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=3 --alpha=0.05 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=3 --alpha=0.05 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s5alpha0.05 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=5 --alpha=0.05 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=5 --alpha=0.05 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=5 --alpha=0.05 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s7alpha0.05 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=7 --alpha=0.05 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=7 --alpha=0.05 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=7 --alpha=0.05 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s9alpha0.05 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=9 --alpha=0.05 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=9 --alpha=0.05 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=9 --alpha=0.05 --logic=Product >> prod_seeds.txt
-done
-
-cd ..
-
-mkdir s11alpha0.05 && cd $_
-
-for i in {1..50}
-do
-  ../examples/fuzzthat --nsets=11 --alpha=0.05 --logic=Godel >> godel_seeds.txt
-  ../examples/fuzzthat --nsets=11 --alpha=0.05 --logic=Łukasiewicz >> luka_seeds.txt
-  ../examples/fuzzthat --nsets=11 --alpha=0.05 --logic=Product >> prod_seeds.txt
-done
+# 50 runs of 100 trials for each point of the grid, in a single process (see Sweep-<seed>.csv):
+../examples/fuzzthat --sweep --nsets=3,5,7,9,11 --alpha=0.00005,0.0005,0.005,0.05 --logic=All --trials=5000
 
 cd ..
@@ -0,0 +1,75 @@
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include "cj/data/csv_chunk_reader.hh"
+
+using reader_type = cj::csv_chunk_reader<double, uint32_t>;
+
+TEST(CJCsvChunkReader, ReadsFileByChunks) {
+  auto const dm = cj::data_matrix<double, uint32_t>::from_file("../data/poll_plant/poll.csv");
+  auto reader = reader_type::open("../data/poll_plant/poll.csv", 100);
+  ASSERT_TRUE(dm && reader);
+  EXPECT_TRUE(cj::is_chunk_source_v<reader_type>);
+  EXPECT_FALSE((cj::is_chunk_source_v<cj::data_matrix<double, uint32_t>>));
+  EXPECT_EQ(dm->input_names(), reader->input_names());
+  EXPECT_EQ(dm->output_name(), reader->output_name());
+
+  auto chunk = reader->make_chunk();
+  for (auto pass = 0; pass < 2; ++pass) {
+    auto row = size_t{0};
+    while (reader->next(chunk)) {
+      ASSERT_EQ(std::min(size_t{100}, dm->nrows() - row), chunk.nrows());
+      for (auto r = size_t{0}; r < chunk.nrows(); ++r, ++row) {
+        for (auto n = size_t{0}; n < dm->ncols(); ++n) {
+          EXPECT_EQ((*dm)(row, n), chunk(r, n));
+        }
+        EXPECT_EQ(dm->get_output(row), chunk.get_output(r));
+      }
+    }
+    EXPECT_EQ(dm->nrows(), row);
+    EXPECT_EQ(0, chunk.nrows());
+    reader->rewind();
+  }
+  EXPECT_FALSE(reader_type::open("no/such/file.csv"));
+}
+
+TEST(CJCsvChunkReader, ReadsAcrossBlocks) {
+  // Rows spanning several blocks of the file, with CRLF, empty lines and no final line break:
+  auto const filename = "csv_chunk_reader_spec.csv";
+  auto const nrows = 100000u;
+  {
+    auto out = std::ofstream{filename, std::ios::binary};
+    out << "a,b,c\r\n";
+    for (auto r = 0u; r < nrows; ++r) {
+      out << r << ',' << 0.5 * r << ',' << r % 2 << (r + 1 < nrows? "\r\n" : "");
+      if (r % 1000 == 0) {
+        out << "\n";
+      }
+    }
+  }
+  auto reader = reader_type::open(filename, 7777);
+  ASSERT_TRUE(reader);
+  EXPECT_EQ((cj::vector<cj::string>{"a", "b"}), reader->input_names());
+  auto chunk = reader->make_chunk();
+  auto row = 0u;
+  auto nchunks = 0u;
+  while (reader->next(chunk)) {
+    ++nchunks;
+    for (auto r = size_t{0}; r < chunk.nrows(); ++r, ++row) {
+      EXPECT_EQ(double(row), chunk(r, 0));
+      EXPECT_EQ(0.5 * row, chunk(r, 1));
+      EXPECT_EQ(row % 2, chunk.get_output(r));
+    }
+  }
+  EXPECT_EQ(nrows, row);
+  EXPECT_EQ((nrows + 7776) / 7777, nchunks);
+
+  {
+    auto out = std::ofstream{filename, std::ios::binary};
+    out << "a,b,c\n1,2,0\n1,2\n";
+  }
+  reader = reader_type::open(filename);
+  ASSERT_TRUE(reader);
+  EXPECT_THROW(reader->next(chunk), std::runtime_error);
+  std::remove(filename);
+}
@@ -11,3 +11,98 @@ TEST(CJDataMatrix, CreatesDataMatrix) {
   EXPECT_DOUBLE_EQ(0.4292307692307692, d->operator()(4, 3));
   EXPECT_DOUBLE_EQ(1, d->get_output(0));
 }
+
+TEST(CJDataMatrix, StoresColumns) {
+  auto dm = cj::data_matrix<double, uint32_t>{{"x", "y"}, "z"};
+  for (auto r = 0u; r < 5; ++r) {
+    EXPECT_TRUE(dm.add_row({{double(r), 10.0 * r}, r % 2}));
+  }
+  EXPECT_FALSE(dm.add_row({{1.0}, 0}));
+
+  auto const y = dm.column(1);
+  ASSERT_EQ(5, y.size());
+  EXPECT_DOUBLE_EQ(30.0, y[3]);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(y.data()) % alignof(double));
+  EXPECT_EQ(y.data(), dm.extract_column("y").data()); // No copy.
+  EXPECT_TRUE(dm.extract_column("w").empty());
+  EXPECT_EQ(1, dm.outputs()[3]);
+
+  auto const row = dm(4);
+  EXPECT_EQ(2, row.first.size());
+  EXPECT_DOUBLE_EQ(40.0, row.first[1]);
+  EXPECT_EQ(4, row.first.row());
+  EXPECT_EQ(0, row.second);
+  EXPECT_EQ((cj::vector<double>{4.0, 40.0}), row.first.to_vector());
+
+  auto sum = 0.0;
+  auto n = 0;
+  for (auto const& r : dm) {
+    sum += r.first[0];
+    n += r.second;
+  }
+  EXPECT_DOUBLE_EQ(10.0, sum);
+  EXPECT_EQ(2, n);
+  EXPECT_EQ(5, std::distance(dm.begin(), dm.end()));
+}
+
+TEST(CJDataMatrix, SplitsFrame) {
+  auto dm = cj::data_matrix<double, uint32_t>{{"x", "y"}, "z"};
+  for (auto r = 0u; r < 100; ++r) {
+    dm.add_row({{double(r), -double(r)}, r % 3});
+  }
+  auto const test = dm.split_frame(0.2, 42);
+  EXPECT_EQ(20, test.nrows());
+  EXPECT_EQ(80, dm.nrows());
+
+  // Every row is in one of the two matrices, and the rows stay whole and in order:
+  auto seen = cj::vector<int>(100, 0);
+  for (auto const* m : {&std::as_const(dm), &test}) {
+    for (auto r = 0u; r < m->nrows(); ++r) {
+      auto const x = (*m)(r, 0);
+      ++seen[size_t(x)];
+      EXPECT_DOUBLE_EQ(-x, (*m)(r, 1));
+      EXPECT_EQ(uint32_t(x) % 3, m->get_output(r));
+      if (r > 0) {
+        EXPECT_LT((*m)(r - 1, 0), x);
+      }
+    }
+  }
+  for (auto const s : seen) {
+    EXPECT_EQ(1, s);
+  }
+}
+
+TEST(CJDataMatrix, ParsesText) {
+  auto const d = cj::data_matrix<double, uint32_t>::from_str("x,y,z\r\n1.5, -2,1\r\n\r\n+3e2,0.25,0\n");
+  ASSERT_TRUE(d);
+  EXPECT_EQ(2, d->nrows());
+  EXPECT_EQ("z", d->output_name());
+  EXPECT_DOUBLE_EQ(-2.0, (*d)(0, 1));
+  EXPECT_DOUBLE_EQ(300.0, (*d)(1, 0));
+  EXPECT_EQ(0, d->get_output(1));
+
+  EXPECT_FALSE((cj::data_matrix<double, uint32_t>::from_str("x,y,z\n1,2\n")));
+  EXPECT_FALSE((cj::data_matrix<double, uint32_t>::from_str("x,y,z\n1,2,3,4\n")));
+  EXPECT_FALSE((cj::data_matrix<double, uint32_t>::from_str("x,y,z\n1,a,3\n")));
+  EXPECT_FALSE((cj::data_matrix<double, uint32_t>::from_str("")));
+  EXPECT_EQ(0, (cj::data_matrix<double, uint32_t>::from_str("x,y,z")->nrows()));
+  EXPECT_EQ(1, (cj::data_matrix<double, std::string>::from_str("x;y\n1;yes", ';')->nrows()));
+}
+
+TEST(CJDataMatrix, ParsesInParallel) {
+  auto txt = std::string{"a,b,c\n"};
+  for (auto r = 0u; r < 50000; ++r) {
+    txt += std::to_string(r) + "," + std::to_string(0.5 * r) + "," + std::to_string(r % 2) + "\n";
+  }
+  auto const serial = cj::data_matrix<double, uint32_t>::from_str(txt, ',', 1);
+  auto const parallel = cj::data_matrix<double, uint32_t>::from_str(txt, ',', 7);
+  ASSERT_TRUE(serial && parallel);
+  ASSERT_EQ(50000, parallel->nrows());
+  for (auto r = 0u; r < 50000; ++r) {
+    EXPECT_EQ(double(r), (*parallel)(r, 0));
+    EXPECT_EQ((*serial)(r, 1), (*parallel)(r, 1));
+    EXPECT_EQ(r % 2, parallel->get_output(r));
+  }
+  txt += "1,2\n";
+  EXPECT_FALSE((cj::data_matrix<double, uint32_t>::from_str(txt, ',', 7)));
+}
@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+#include "cj/data/data_matrix_view.hh"
+
+TEST(CJDataMatrixView, ViewsRowsByIndex) {
+  auto dm = cj::data_matrix<double, uint32_t>{{"x", "y"}, "z"};
+  for (auto r = 0u; r < 5; ++r) {
+    dm.add_row({{double(r), 10.0 * r}, r % 2});
+  }
+
+  auto const all = cj::data_matrix_view<double, uint32_t>{dm};
+  EXPECT_EQ(5, all.nrows());
+  EXPECT_EQ(dm.ncols(), all.ncols());
+  EXPECT_EQ("y", all.input_name(1));
+  EXPECT_EQ("z", all.output_name());
+  EXPECT_EQ(&dm, &all.matrix());
+
+  auto const v = cj::data_matrix_view<double, uint32_t>{dm, {4, 1, 1}};
+  EXPECT_EQ(3, v.size());
+  EXPECT_FALSE(v.empty());
+  EXPECT_DOUBLE_EQ(4.0, v(0, 0));
+  EXPECT_DOUBLE_EQ(10.0, v(2, 1));
+  EXPECT_EQ(0, v.get_output(0));
+  EXPECT_EQ(1, v.get_output(1));
+  EXPECT_EQ(1, v(2).first.row()); // No copy.
+
+  auto xs = cj::vector<double>{};
+  for (auto const& row : v) {
+    xs.push_back(row.first[0]);
+  }
+  EXPECT_EQ((cj::vector<double>{4.0, 1.0, 1.0}), xs);
+  EXPECT_EQ(3, std::distance(v.begin(), v.end()));
+}
+
+TEST(CJDataMatrixView, SamplesSharedMatrix) {
+  auto dm = cj::data_matrix<double, uint32_t>{{"x"}, "y"};
+  for (auto r = 0u; r < 1000; ++r) {
+    dm.add_row({{double(r)}, r % 10 == 0? 1u : 0u});
+  }
+  auto const shared = std::make_shared<cj::data_matrix<double, uint32_t> const>(std::move(dm));
+  auto const all = cj::data_matrix_view<double, uint32_t>{shared};
+  auto rng = std::mt19937_64(42);
+
+  // A split is a partition of the rows, in their order, and shares the matrix:
+  auto const [training, testing] = all.split(0.2, rng);
+  EXPECT_EQ(800, training.nrows());
+  EXPECT_EQ(200, testing.nrows());
+  EXPECT_EQ(shared.get(), &testing.matrix());
+  auto seen = cj::vector<int>(1000, 0);
+  for (auto const* v : {&training, &testing}) {
+    EXPECT_TRUE(std::is_sorted(v->indices().begin(), v->indices().end()));
+    for (auto const r : v->indices()) {
+      ++seen[r];
+    }
+  }
+  EXPECT_EQ(cj::vector<int>(1000, 1), seen);
+
+  // The same split as split_frame for the same random generator:
+  auto copy = *shared;
+  auto frame_rng = std::mt19937_64(42);
+  auto const frame_test = copy.split_frame(0.2, frame_rng);
+  ASSERT_EQ(frame_test.nrows(), testing.nrows());
+  for (auto r = 0u; r < testing.nrows(); ++r) {
+    EXPECT_EQ(frame_test(r, 0), testing(r, 0));
+  }
+
+  // Each output keeps its proportion in both sides of a stratified split:
+  auto const [rest, strata] = all.stratified_split(0.3, rng);
+  auto positives = 0u;
+  for (auto const& row : strata) {
+    positives += row.second;
+  }
+  EXPECT_EQ(300, strata.nrows());
+  EXPECT_EQ(30, positives);
+  EXPECT_EQ(700, rest.nrows());
+
+  auto const boot = training.bootstrap(1500, rng);
+  EXPECT_EQ(1500, boot.nrows());
+  for (auto const r : boot.indices()) {
+    EXPECT_NE(std::find(training.indices().begin(), training.indices().end(), r), training.indices().end());
+  }
+
+  auto const sub = testing.subsample(50, rng);
+  EXPECT_EQ(50, sub.nrows());
+  EXPECT_TRUE(std::is_sorted(sub.indices().begin(), sub.indices().end()));
+  EXPECT_EQ(200, testing.subsample(500, rng).nrows());
+  EXPECT_EQ(testing.indices()[3], testing.select({3}).indices()[0]);
+}
+
+TEST(CJDataMatrixView, SplitsMillionRowsQuickly) {
+  auto dm = cj::data_matrix<double, uint32_t>{{"x"}, "y"};
+  dm.reserve(1000000);
+  for (auto r = 0u; r < 1000000; ++r) {
+    dm.add_row({{double(r)}, r % 2});
+  }
+  auto rng = std::mt19937_64(7);
+  auto const [training, testing] = cj::data_matrix_view<double, uint32_t>{dm}.split(0.5, rng);
+  EXPECT_EQ(500000, testing.nrows());
+  EXPECT_EQ(1000000, dm.nrows());
+}
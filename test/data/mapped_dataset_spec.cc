@@ -0,0 +1,97 @@
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include "cj/data/mapped_dataset.hh"
+#include "cj/data/csv_chunk_reader.hh"
+#include "cj/logics/fuzzy_classifier.hh"
+
+using mapped = cj::mapped_dataset<double, uint32_t>;
+
+TEST(CJMappedDataset, MapsWrittenDataMatrix) {
+  auto const dm = cj::data_matrix<double, uint32_t>::from_file("../data/poll_plant/poll.csv");
+  ASSERT_TRUE(dm);
+  auto const filename = "mapped_dataset_spec.cjdm";
+  ASSERT_TRUE(mapped::write(*dm, filename, {12, 34}, ';'));
+
+  auto md = mapped::open(filename, 500);
+  ASSERT_TRUE(md);
+  EXPECT_EQ(dm->nrows(), md->nrows());
+  EXPECT_EQ(dm->input_names(), md->input_names());
+  EXPECT_EQ(dm->output_name(), md->output_name());
+  EXPECT_EQ(12, md->source().size);
+  EXPECT_EQ(34, md->source().time);
+  EXPECT_EQ(';', md->source_delim());
+  for (auto n = size_t{0}; n < md->ncols(); ++n) {
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(md->column(n).data()) % 64);
+    for (auto r = size_t{0}; r < md->nrows(); ++r) {
+      EXPECT_EQ((*dm)(r, n), md->column(n)[r]);
+    }
+  }
+  auto const copy = md->to_data_matrix();
+  for (auto r = size_t{0}; r < dm->nrows(); ++r) {
+    EXPECT_EQ(dm->get_output(r), md->outputs()[r]);
+    EXPECT_EQ(dm->get_output(r), copy.get_output(r));
+  }
+
+  // The columns are fuzzified in place, and the rows can be read by chunks:
+  using classifier = cj::fuzzy_classifier<cj::lukasiewicz<double>, double>;
+  auto i = classifier::make_interpretation({"No", "Yes"});
+  for (auto const& name : dm->input_names()) {
+    i->add_triangular_partition(name, 3, 0.0, 1.0);
+  }
+  auto c = classifier{i, {{{{0, 2}, {3, 1}}, 1}, {{{5, 0}}, 0}}};
+  c.compile();
+  auto const expected = c.evaluate_all(*dm);
+  EXPECT_TRUE(cj::is_chunk_source_v<mapped>);
+  for (auto const& con : {c.evaluate_all(cj::membership_tensor<cj::lukasiewicz<double>>{*md, *i}), c.evaluate_all(*md)}) {
+    for (auto p = 0u; p < 2; ++p) {
+      for (auto o = 0u; o < 2; ++o) {
+        EXPECT_EQ(expected(p, o), con(p, o));
+      }
+    }
+  }
+
+  EXPECT_FALSE((cj::mapped_dataset<float, uint32_t>::open(filename)));
+  EXPECT_FALSE(mapped::open("../data/poll_plant/poll.csv"));
+  EXPECT_FALSE(mapped::open("no/such/file.cjdm"));
+  std::remove(filename);
+}
+
+TEST(CJMappedDataset, LoadsThroughCache) {
+  auto const filename = "mapped_dataset_spec.csv";
+  auto const cache = cj::cached_filename(filename);
+  std::remove(cache.c_str());
+  {
+    auto out = std::ofstream{filename};
+    out << "x,y,z\n1,2,0\n3,4,1\n";
+  }
+  auto const first = cj::load_cached<double, uint32_t>(filename);
+  ASSERT_TRUE(first);
+  EXPECT_EQ(2, first->nrows());
+  auto md = mapped::open(cache.c_str());
+  ASSERT_TRUE(md);
+  EXPECT_EQ(cj::source_stamp::of(filename)->size, md->source().size);
+
+  // The cache is used while the CSV file is unchanged:
+  auto const second = cj::load_cached<double, uint32_t>(filename);
+  ASSERT_TRUE(second);
+  EXPECT_EQ(2, second->nrows());
+  EXPECT_DOUBLE_EQ(4.0, (*second)(1, 1));
+  EXPECT_EQ(1, second->get_output(1));
+
+  // And rewritten when it changes:
+  {
+    auto out = std::ofstream{filename, std::ios::app};
+    out << "5,6,1\n";
+  }
+  auto const third = cj::load_cached<double, uint32_t>(filename);
+  ASSERT_TRUE(third);
+  EXPECT_EQ(3, third->nrows());
+  md = mapped::open(cache.c_str());
+  ASSERT_TRUE(md);
+  EXPECT_EQ(3, md->nrows());
+
+  EXPECT_FALSE((cj::load_cached<double, uint32_t>("no/such/file.csv")));
+  std::remove(filename);
+  std::remove(cache.c_str());
+}
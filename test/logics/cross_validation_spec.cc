@@ -0,0 +1,115 @@
+#include "gtest/gtest.h"
+#include "cj/logics/fuzzy_classifier.hh"
+#include "cj/logics/cross_validation.hh"
+#include "cj/data/data_matrix_view.hh"
+
+using luka = cj::lukasiewicz<double>;
+using classifier = cj::fuzzy_classifier<luka, double>;
+using prepared = cj::prepared_dataset<classifier>;
+
+static auto make_dataset(size_t nrows) -> prepared::const_ptr {
+  auto rng = std::mt19937_64(3);
+  auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+  auto dm = cj::data_matrix<double, uint32_t>{{"x", "y"}, "z"};
+  for (auto r = 0u; r < nrows; ++r) {
+    auto const x = unif(rng), y = unif(rng);
+    dm.add_row({{x, y}, uint32_t(x * y > 0.4)});
+  }
+  auto i = classifier::make_interpretation({"No", "Yes"});
+  i->add_triangular_partition("x", 3, 0.0, 1.0);
+  i->add_triangular_partition("y", 4, 0.0, 1.0);
+  return prepared::make(std::move(dm), i);
+}
+
+// Checks that each repeat's folds test every row once and train on the others.
+static auto check_partitions(cj::vector<cj::cv_fold> const& folds, size_t nrows, size_t k, size_t repeats) -> void {
+  ASSERT_EQ(k * repeats, folds.size());
+  for (auto rep = 0u; rep < repeats; ++rep) {
+    auto tested = cj::vector<int>(nrows, 0);
+    for (auto f = 0u; f < k; ++f) {
+      auto const& fold = folds[rep * k + f];
+      EXPECT_EQ(rep, fold.repeat);
+      EXPECT_EQ(f, fold.fold);
+      EXPECT_EQ(nrows, fold.training.size() + fold.testing.size());
+      EXPECT_LE(fold.testing.size(), nrows / k + 1);
+      EXPECT_GE(fold.testing.size(), nrows / k);
+      EXPECT_TRUE(std::is_sorted(fold.training.begin(), fold.training.end()));
+      for (auto const r : fold.testing) {
+        ++tested[r];
+        EXPECT_FALSE(std::binary_search(fold.training.begin(), fold.training.end(), r));
+      }
+    }
+    for (auto const t : tested) {
+      EXPECT_EQ(1, t);
+    }
+  }
+}
+
+TEST(CJCrossValidation, SplitsRowsInFolds) {
+  check_partitions(cj::kfold(103, 5, 3, 42), 103, 5, 3);
+  check_partitions(cj::kfold(10, 10, 1, 42), 10, 10, 1);
+
+  auto const folds = cj::kfold(50, 2, 2, 7);
+  EXPECT_NE(folds[0].testing, folds[2].testing); // Each repeat is shuffled.
+  EXPECT_EQ(folds[0].testing, cj::kfold(50, 2, 2, 7)[0].testing);
+}
+
+TEST(CJCrossValidation, StratifiesFolds) {
+  auto outputs = cj::vector<uint32_t>{};
+  for (auto r = 0u; r < 97; ++r) {
+    outputs.push_back(r % 7 == 0? 1 : 0);
+  }
+  auto const folds = cj::stratified_kfold(outputs, 4, 2, 42);
+  check_partitions(folds, outputs.size(), 4, 2);
+  auto const positives = size_t(std::count(outputs.begin(), outputs.end(), 1u));
+  for (auto const& fold : folds) {
+    auto const p = size_t(std::count_if(fold.testing.begin(), fold.testing.end(),
+                                        [&](size_t r) { return outputs[r] == 1; }));
+    EXPECT_LE(p, positives / 4 + 1);
+    EXPECT_GE(p, positives / 4);
+  }
+}
+
+TEST(CJCrossValidation, GathersTensorsOfFolds) {
+  auto const ds = make_dataset(60);
+  auto const rows = cj::vector<size_t>{5, 0, 59, 5};
+  auto const gathered = classifier::membership_tensor_type{ds->memberships(), rows};
+  auto const fuzzified = classifier::membership_tensor_type{
+    ds->data().select(rows), *ds->interpretation()};
+  ASSERT_EQ(4, gathered.nrows());
+  ASSERT_EQ(fuzzified.num_columns(), gathered.num_columns());
+  for (auto r = 0u; r < rows.size(); ++r) {
+    EXPECT_EQ(fuzzified.output(r), gathered.output(r));
+    for (auto c = 0u; c < gathered.num_columns(); ++c) {
+      EXPECT_EQ(fuzzified.column(c)[r], gathered.column(c)[r]);
+    }
+  }
+}
+
+TEST(CJCrossValidation, PoolsFoldsResults) {
+  auto const ds = make_dataset(200);
+  auto const rules = classifier::rules_type{{{{0, 2}, {1, 3}}, 1}, {{{0, 0}}, 0}, {{{1, 1}}, 0}};
+  auto const fixed = [&](classifier::membership_tensor_type const& training, cj::cv_fold const&) {
+    EXPECT_EQ(160, training.nrows());
+    return ds->classifier(rules);
+  };
+
+  auto const folds = cj::kfold(ds->nrows(), 5, 2, 42);
+  auto const serial = cj::cross_validate(*ds, folds, fixed, 1);
+  auto const parallel = cj::cross_validate(*ds, folds, fixed, 4);
+
+  // A fixed classifier sees every row once per repeat:
+  auto const whole = ds->classifier(rules).evaluate_all(ds->memberships());
+  EXPECT_EQ(400, serial.pooled.count());
+  for (auto p = 0u; p < 2; ++p) {
+    for (auto o = 0u; o < 2; ++o) {
+      EXPECT_EQ(2 * whole(p, o), serial.pooled(p, o));
+      EXPECT_EQ(serial.pooled(p, o), parallel.pooled(p, o));
+    }
+  }
+  ASSERT_EQ(10, serial.tss.size());
+  EXPECT_EQ(serial.tss, parallel.tss);
+  auto const mean = std::accumulate(serial.tss.begin(), serial.tss.end(), 0.0) / 10;
+  EXPECT_NEAR(mean, serial.mean_tss, 1e-12);
+  EXPECT_GT(serial.sd_tss, 0.0);
+}
@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+#include "cj/logics/fuzzy_classifier.hh"
+#include "cj/logics/delta_evaluator.hh"
+
+template<typename Truth>
+auto delta_matches_full_evaluation() -> void {
+  using classifier = cj::fuzzy_classifier<Truth, double>;
+  using rule_type = typename classifier::rule_type;
+
+  auto i = classifier::make_interpretation({"A", "B", "C"});
+  i->add_triangular_partition("x", 3, 0.0, 1.0);
+  i->add_triangular_partition("y", 5, 0.0, 1.0);
+  i->add_triangular_partition("z", 2, 0.0, 1.0);
+
+  auto rng = std::mt19937_64(1234);
+  auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+  auto dm = cj::data_matrix<double, uint32_t>{{"x", "y", "z"}, "class"};
+  for (auto r = 0u; r < 300; ++r) {
+    dm.add_row({{unif(rng), unif(rng), unif(rng)}, uint32_t(unif(rng) * 3)});
+  }
+
+  auto c = classifier{i, {{{{0, 0}}, 0}, {{{1, 2}}, 1}}};
+  auto const mt = c.fuzzify(dm);
+  auto delta = cj::delta_evaluator<classifier>{c, mt};
+
+  auto const same = [&](cj::confusion<size_t, double> const& x, cj::confusion<size_t, double> const& y) {
+    for (auto p = 0u; p < 3; ++p) {
+      for (auto o = 0u; o < 3; ++o) {
+        EXPECT_EQ(x(p, o), y(p, o));
+      }
+    }
+  };
+  same(c.evaluate_all(mt), delta.results());
+
+  for (auto step = 0u; step < 200; ++step) {
+    if (c.size() < 2 || unif(rng) < 0.5) {
+      auto rule = rule_type{};
+      auto const nlits = 1 + uint32_t(unif(rng) * 3);
+      for (auto l = 0u; l < nlits; ++l) {
+        auto const input = uint32_t(unif(rng) * 3);
+        rule.first[input] = uint32_t(unif(rng) * i->num_partitions(input));
+      }
+      c.add_rule(rule.first, uint32_t(unif(rng) * 3));
+    } else {
+      c.pop_random_rule(rng);
+    }
+    same(c.evaluate_all(mt), delta.update(c));
+    EXPECT_EQ(c.size(), delta.size());
+  }
+
+  for (auto r = 0u; r < mt.nrows(); ++r) {
+    EXPECT_EQ(c.evaluate(mt, r), delta.predictions()[r]);
+  }
+}
+
+TEST(CJDeltaEvaluator, LukasiewiczMatchesFullEvaluation) {
+  delta_matches_full_evaluation<cj::lukasiewicz<double>>();
+}
+
+TEST(CJDeltaEvaluator, GodelMatchesFullEvaluation) {
+  delta_matches_full_evaluation<cj::godel<double>>();
+}
+
+TEST(CJDeltaEvaluator, ProductMatchesFullEvaluation) {
+  delta_matches_full_evaluation<cj::product<double>>();
+}
@@ -49,6 +49,93 @@ TEST(CJFuzzyClassifier, CreatesLukasiewiczInterpretation) {
   EXPECT_TRUE(c.empty());
 }
 
+TEST(CJFuzzyClassifier, SamplesPartitionsInLookupTables) {
+  using luka = cj::lukasiewicz<double>;
+  using classifier = cj::fuzzy_classifier<luka, double>;
+
+  auto exact = classifier::make_interpretation({"No", "Yes"});
+  auto sampled = classifier::make_interpretation({"No", "Yes"});
+  exact->add_triangular_partition("x", 5, 0.0, 1.0);
+  sampled->use_lookup_tables(10);
+  sampled->add_triangular_partition("x", 5, 0.0, 1.0);
+  sampled->use_lookup_tables(0);
+  sampled->add_triangular_partition("y", 5, 0.0, 1.0);
+  EXPECT_EQ("Triangular_{5}(0, 1) LUT_{2^10}", sampled->partition_name(0));
+  EXPECT_EQ("Triangular_{5}(0, 1)", sampled->partition_name(1));
+  for (auto s = 0u; s < 5; ++s) {
+    EXPECT_EQ(cj::fuzzy_set_kind::table, sampled->get(0, s).kind());
+    EXPECT_NE(cj::fuzzy_set_kind::table, sampled->get(1, s).kind());
+    for (auto x = 0.0; x <= 1.0; x += 0.01) {
+      EXPECT_NEAR(exact->get(0, s, x).value, sampled->get(0, s, x).value, 4.0 / 2048);
+    }
+  }
+}
+
+TEST(CJFuzzyClassifier, FindsActiveSets) {
+  using luka = cj::lukasiewicz<double>;
+  using classifier = cj::fuzzy_classifier<luka, double>;
+
+  auto i = classifier::make_interpretation({"No", "Yes"});
+  i->add_triangular_partition("x", 7, 0.0, 1.0);
+  i->add_triangular_partition("y", 2, -3.0, 3.0);
+  i->add_triangular_partition("z", 13, 10.0, 20.0);
+  i->use_lookup_tables(8);
+  i->add_triangular_partition("t", 5, 0.0, 1.0);
+  i->use_lookup_tables(0);
+  i->add_partition("u", cj::make_gaussians(4, 0.0, 1.0, luka{0.0}, luka{1.0}), "Gaussian");
+
+  auto xs = cj::vector<double>{std::nan(""), -1e300, 1e300};
+  for (auto x = -5.0; x < 25.0; x += 0.0625) {
+    xs.push_back(x);
+  }
+  for (auto n = 0u; n < i->num_input(); ++n) {
+    for (auto const x : xs) {
+      auto active = cj::vector<cj::pair<uint32_t, luka>>{};
+      i->active_sets(n, x, active);
+      auto expected = cj::vector<cj::pair<uint32_t, luka>>{};
+      for (auto s = 0u; s < i->num_partitions(n); ++s) {
+        if (0.0 < i->get(n, s, x).value) {
+          expected.emplace_back(s, i->get(n, s, x));
+        }
+      }
+      ASSERT_EQ(expected.size(), active.size()) << n << ' ' << x;
+      for (auto k = 0u; k < active.size(); ++k) {
+        EXPECT_EQ(expected[k].first, active[k].first);
+        EXPECT_EQ(expected[k].second.value, active[k].second.value);
+      }
+      if (n != 4) {
+        EXPECT_LE(active.size(), 2);
+      }
+    }
+  }
+}
+
+TEST(CJFuzzyClassifier, AddsAnyPartition) {
+  using luka = cj::lukasiewicz<double>;
+  using classifier = cj::fuzzy_classifier<luka, double>;
+  using fuzzy_set = typename classifier::fuzzy_set_type;
+
+  auto i = classifier::make_interpretation({"No", "Yes"});
+  i->add_partition("x", cj::make_gaussians(3, 0.0, 1.0, luka{0.0}, luka{1.0}), "Gaussian_{3}(0, 1)");
+  i->add_partition("y", {fuzzy_set::interval(-1.0, 0.0, luka{0.0}, luka{1.0}),
+                         fuzzy_set{[](double y) { return luka{y < 0.0? 0.0 : std::min(1.0, y)}; }}},
+                   "Custom", {"is negative", "is positive"});
+  EXPECT_EQ(2, i->num_input());
+  EXPECT_EQ(3, i->num_partitions(0));
+  EXPECT_EQ(2, i->num_partitions(1));
+  EXPECT_EQ("is average", i->label(0, 1));
+  EXPECT_EQ("is positive", i->label(1, 1));
+  EXPECT_EQ("Gaussian_{3}(0, 1)", i->partition_name(0));
+  EXPECT_DOUBLE_EQ(1.0, i->get(0, 1, 0.5).value);
+  EXPECT_DOUBLE_EQ(0.5, i->get(1, 1, 0.5).value);
+  EXPECT_THROW(i->add_partition("z", cj::make_intervals(2, 0.0, 1.0, luka{0.0}, luka{1.0}), "Crisp",
+                                {"is low"}), std::invalid_argument);
+
+  auto const c = classifier{i, {{{{0, 0}}, 0}, {{{1, 1}}, 1}}};
+  EXPECT_EQ(0, c.evaluate({0.0, -0.5}));
+  EXPECT_EQ(1, c.evaluate({1.0, 1.0}));
+}
+
 TEST(CJFuzzyClassifier, CreatesLukasiewiczClassifier) {
   using luka = cj::lukasiewicz<double>;
   using classifier = cj::fuzzy_classifier<luka, double>;
@@ -244,3 +331,529 @@ TEST(CJFuzzyClassifier, AddingEmptyRuleToClassifier) {
   EXPECT_FALSE(c.add_rule(r3));
   EXPECT_EQ(2, c.size());
 }
+
+TEST(CJFuzzyClassifier, CompiledClassifierEvaluatesLikeStaleClassifier) {
+  using luka = cj::lukasiewicz<double>;
+  using classifier = cj::fuzzy_classifier<luka, double>;
+
+  auto i = classifier::make_interpretation({"No-interaction", "Interaction"});
+  i->add_triangular_partition("Body mass",  3,  0.0, 500.0);
+  i->add_triangular_partition("Brain mass", 3, 10.0,  50.0);
+  i->add_triangular_partition("Whatever",   3,  0.0,   1.0);
+  auto c = classifier{i};
+  c.add_rule({{0, 2}, {2, 1}}, 0);
+  c.add_rule({{1, 1}}, 1);
+  EXPECT_FALSE(c.is_compiled());
+
+  auto const rows = cj::vector<cj::vector<double>>{
+    {500, 20, 0.3}, {400, 10, 0.0}, {400, 30, 0.0}, {400, 25, 0.0}, {100, 11, 0.0}, {450, 11, 0.5}
+  };
+  auto stale = cj::vector<uint32_t>{};
+  for (auto const& r : rows) {
+    stale.push_back(c.evaluate(r));
+  }
+
+  c.compile();
+  EXPECT_TRUE(c.is_compiled());
+  for (auto k = 0u; k < rows.size(); ++k) {
+    EXPECT_EQ(stale[k], c.evaluate(rows[k]));
+  }
+
+  c.add_rule({{1, 0}}, 0);
+  EXPECT_FALSE(c.is_compiled());
+  c.compile();
+  c.rmv_rule({{1, 0}});
+  EXPECT_FALSE(c.is_compiled());
+  c.compile();
+  for (auto k = 0u; k < rows.size(); ++k) {
+    EXPECT_EQ(stale[k], c.evaluate(rows[k]));
+  }
+
+  EXPECT_THROW(c.evaluate({500, 20}), std::out_of_range);
+}
+
+TEST(CJFuzzyClassifier, EvaluatesMembershipTensorFuzzyClassifier) {
+  using prod = cj::product<double>;
+  using classifier = cj::fuzzy_classifier<prod, double>;
+
+  auto i = classifier::make_interpretation({"No-interaction", "Interaction"});
+  i->add_triangular_partition("Body mass",  3,  0.0, 500.0);
+  i->add_triangular_partition("Brain mass", 5, 10.0,  50.0);
+  i->add_triangular_partition("Whatever",   2,  0.0,   1.0);
+  auto c = classifier{i};
+  c.add_rule({{0, 2}, {2, 1}}, 0);
+  c.add_rule({{1, 1}}, 1);
+  c.add_rule({{1, 3}, {2, 0}}, 1);
+
+  auto dm = cj::data_matrix<double, uint32_t>{{"Body Mass", "Brain Mass", "Whatever"}, "Interaction"};
+  using row_type = cj::pair<cj::vector<double>, uint32_t>;
+  dm.add_row(row_type({500, 20, 0.3}, 1));
+  dm.add_row(row_type({400, 10, 0.0}, 1));
+  dm.add_row(row_type({400, 30, 0.0}, 1));
+  dm.add_row(row_type({400, 25, 0.0}, 0));
+  dm.add_row(row_type({400, 15, 0.0}, 1));
+  dm.add_row(row_type({100, 11, 0.9}, 1));
+  dm.add_row(row_type({450, 11, 0.5}, 0));
+
+  auto const mt = c.fuzzify(dm);
+  EXPECT_EQ(7, mt.nrows());
+  EXPECT_EQ(3, mt.num_input());
+  EXPECT_EQ(10, mt.num_columns());
+  EXPECT_EQ(8, mt.column_index(2, 0));
+  for (auto r = 0u; r < dm.nrows(); ++r) {
+    EXPECT_EQ(dm.get_output(r), mt.output(r));
+    for (auto n = 0u; n < i->num_input(); ++n) {
+      for (auto s = 0u; s < i->num_partitions(n); ++s) {
+        EXPECT_EQ(i->get(n, s, dm(r, n)), mt(r, n, s));
+      }
+    }
+    EXPECT_EQ(c.evaluate(dm(r).first), c.evaluate(mt, r));
+  }
+
+  auto const from_rows = c.evaluate_all(dm);
+  auto const from_tensor = c.evaluate_all(mt);
+  for (auto p = 0u; p < 2; ++p) {
+    for (auto o = 0u; o < 2; ++o) {
+      EXPECT_EQ(from_rows(p, o), from_tensor(p, o));
+    }
+  }
+}
+
+template<typename Truth>
+auto batch_matches_rows() -> void {
+  using classifier = cj::fuzzy_classifier<Truth, double>;
+
+  auto i = classifier::make_interpretation({"A", "B", "C"});
+  i->add_triangular_partition("x", 3, 0.0, 1.0);
+  i->add_triangular_partition("y", 5, 0.0, 1.0);
+  i->add_triangular_partition("z", 7, 0.0, 1.0);
+  auto c = classifier{i};
+  c.add_rule({{0, 0}}, 0);
+  c.add_rule({{0, 2}, {1, 1}}, 1);
+  c.add_rule({{1, 3}, {2, 2}}, 2);
+  c.add_rule({{0, 1}, {1, 2}, {2, 5}}, 1);
+  c.add_rule({{2, 6}}, 2);
+  c.compile();
+
+  auto rng = std::mt19937_64(42);
+  auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+  auto dm = cj::data_matrix<double, uint32_t>{{"x", "y", "z"}, "class"};
+  for (auto r = 0u; r < 1000; ++r) {
+    dm.add_row({{unif(rng), unif(rng), unif(rng)}, uint32_t(unif(rng) * 3)});
+  }
+  auto const mt = c.fuzzify(dm);
+  auto const from_rows = c.evaluate_all(dm);
+  auto const from_tensor = c.evaluate_all(mt);
+  EXPECT_EQ(1000, from_tensor.count());
+  for (auto p = 0u; p < 3; ++p) {
+    for (auto o = 0u; o < 3; ++o) {
+      EXPECT_EQ(from_rows(p, o), from_tensor(p, o));
+    }
+  }
+}
+
+TEST(CJFuzzyClassifier, BatchEvaluationMatchesRowEvaluation) {
+  batch_matches_rows<cj::lukasiewicz<double>>();
+  batch_matches_rows<cj::godel<double>>();
+  batch_matches_rows<cj::product<double>>();
+  batch_matches_rows<cj::lukasiewicz<float>>();
+  batch_matches_rows<cj::product<float>>();
+  batch_matches_rows<cj::lukasiewicz<cj::fixed16>>();
+  batch_matches_rows<cj::godel<cj::fixed16>>();
+  batch_matches_rows<cj::product<cj::fixed16>>();
+}
+
+template<typename Truth>
+auto early_exits_match_exhaustive_evaluation() -> void {
+  using classifier = cj::fuzzy_classifier<Truth, double>;
+
+  auto i = classifier::make_interpretation({"A", "B", "C"});
+  i->add_triangular_partition("x", 3, 0.0, 1.0);
+  i->add_triangular_partition("y", 4, 0.0, 1.0);
+  i->add_triangular_partition("z", 6, 0.0, 1.0);
+
+  auto rng = std::mt19937_64(3);
+  auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+  auto c = classifier{i};
+  for (auto r = 0u; r < 40; ++r) {
+    auto rule = typename classifier::rule_type{};
+    for (auto n = 0u; n < 3; ++n) {
+      if (unif(rng) < 0.5) {
+        rule.first[n] = uint32_t(unif(rng) * i->num_partitions(n));
+      }
+    }
+    rule.second = uint32_t(unif(rng) * 3);
+    c.add_rule(rule);
+  }
+  c.compile();
+
+  auto dm = cj::data_matrix<double, uint32_t>{{"x", "y", "z"}, "class"};
+  for (auto r = 0u; r < 700; ++r) {
+    dm.add_row({{unif(rng), unif(rng), unif(rng)}, uint32_t(unif(rng) * 3)});
+  }
+
+  // Every literal of every rule, in the order of the knowledge base:
+  auto expected = cj::confusion<size_t, double>{3};
+  for (auto const& row : dm) {
+    auto by_classes = cj::vector<Truth>(3, Truth{0});
+    for (auto const& rule : c.rules()) {
+      auto truth = Truth{1};
+      for (auto const& v : rule.first) {
+        truth = truth && i->get(v.first, v.second)(row.first[v.first]);
+      }
+      by_classes[rule.second] = by_classes[rule.second] || truth;
+    }
+    auto const prediction = cj::idx_of_maximum(by_classes);
+    EXPECT_EQ(prediction, c.evaluate(row.first));
+    expected.add_count(prediction, row.second);
+  }
+  auto const mt = c.fuzzify(dm);
+  auto const from_tensor = c.evaluate_all(mt);
+  for (auto p = 0u; p < 3; ++p) {
+    for (auto o = 0u; o < 3; ++o) {
+      EXPECT_EQ(expected(p, o), from_tensor(p, o));
+    }
+  }
+}
+
+TEST(CJFuzzyClassifier, EarlyExitsMatchExhaustiveEvaluation) {
+  early_exits_match_exhaustive_evaluation<cj::lukasiewicz<double>>();
+  early_exits_match_exhaustive_evaluation<cj::godel<double>>();
+  early_exits_match_exhaustive_evaluation<cj::product<double>>();
+  early_exits_match_exhaustive_evaluation<cj::lukasiewicz<float>>();
+  early_exits_match_exhaustive_evaluation<cj::product<float>>();
+  early_exits_match_exhaustive_evaluation<cj::lukasiewicz<cj::fixed16>>();
+  early_exits_match_exhaustive_evaluation<cj::godel<cj::fixed16>>();
+  early_exits_match_exhaustive_evaluation<cj::product<cj::fixed16>>();
+}
+
+template<typename Truth>
+auto trie_evaluation_matches_exhaustive_evaluation() -> void {
+  using classifier = cj::fuzzy_classifier<Truth, double>;
+
+  auto i = classifier::make_interpretation({"A", "B", "C"});
+  for (auto n = 0u; n < 5; ++n) {
+    i->add_triangular_partition("x" + std::to_string(n), 3, 0.0, 1.0);
+  }
+
+  // Rules extending a few prefixes (some of which are rules too), for all the classes:
+  auto rng = std::mt19937_64(11);
+  auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+  auto c = classifier{i};
+  auto const prefixes = cj::vector<typename classifier::antecedent_type>{
+    {{0, 1}}, {{0, 1}, {1, 0}}, {{0, 2}, {2, 1}}, {{1, 1}, {2, 2}, {3, 0}}
+  };
+  for (auto const& p : prefixes) {
+    c.add_rule(p, uint32_t(unif(rng) * 3));
+    for (auto k = 0u; k < 10; ++k) {
+      auto a = p;
+      for (auto n = p.rbegin()->first + 1u; n < 5; ++n) {
+        if (unif(rng) < 0.5) {
+          a[n] = uint32_t(unif(rng) * 3);
+        }
+      }
+      c.add_rule(a, uint32_t(unif(rng) * 3));
+    }
+  }
+  c.compile();
+
+  auto dm = cj::data_matrix<double, uint32_t>{{"x0", "x1", "x2", "x3", "x4"}, "class"};
+  for (auto r = 0u; r < 600; ++r) {
+    auto row = cj::vector<double>{};
+    for (auto n = 0u; n < 5; ++n) {
+      row.push_back(unif(rng));
+    }
+    dm.add_row({row, uint32_t(unif(rng) * 3)});
+  }
+
+  auto expected = cj::confusion<size_t, double>{3};
+  for (auto const& row : dm) {
+    auto by_classes = cj::vector<Truth>(3, Truth{0});
+    for (auto const& rule : c.rules()) {
+      auto truth = Truth{1};
+      for (auto const& v : rule.first) {
+        truth = truth && i->get(v.first, v.second)(row.first[v.first]);
+      }
+      by_classes[rule.second] = by_classes[rule.second] || truth;
+    }
+    expected.add_count(cj::idx_of_maximum(by_classes), row.second);
+  }
+  auto const from_tensor = c.evaluate_all(c.fuzzify(dm));
+  for (auto p = 0u; p < 3; ++p) {
+    for (auto o = 0u; o < 3; ++o) {
+      EXPECT_EQ(expected(p, o), from_tensor(p, o));
+    }
+  }
+}
+
+TEST(CJFuzzyClassifier, TrieEvaluationMatchesExhaustiveEvaluation) {
+  trie_evaluation_matches_exhaustive_evaluation<cj::lukasiewicz<double>>();
+  trie_evaluation_matches_exhaustive_evaluation<cj::godel<double>>();
+  trie_evaluation_matches_exhaustive_evaluation<cj::product<double>>();
+  trie_evaluation_matches_exhaustive_evaluation<cj::lukasiewicz<float>>();
+  trie_evaluation_matches_exhaustive_evaluation<cj::product<float>>();
+  trie_evaluation_matches_exhaustive_evaluation<cj::lukasiewicz<cj::fixed16>>();
+  trie_evaluation_matches_exhaustive_evaluation<cj::godel<cj::fixed16>>();
+  trie_evaluation_matches_exhaustive_evaluation<cj::product<cj::fixed16>>();
+}
+
+template<typename Truth>
+auto indexed_evaluation_matches_exhaustive_evaluation() -> void {
+  using classifier = cj::fuzzy_classifier<Truth, double>;
+
+  auto i = classifier::make_interpretation({"A", "B", "C"});
+  for (auto n = 0u; n < 6; ++n) {
+    i->add_triangular_partition("x" + std::to_string(n), 3 + n, 0.0, 1.0);
+  }
+
+  auto rng = std::mt19937_64(7);
+  auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+  auto random_rule = [&]() {
+    auto rule = typename classifier::rule_type{};
+    while (rule.first.empty()) {
+      for (auto n = 0u; n < 6; ++n) {
+        if (unif(rng) < 0.3) {
+          rule.first[n] = uint32_t(unif(rng) * i->num_partitions(n));
+        }
+      }
+    }
+    rule.second = uint32_t(unif(rng) * 3);
+    return rule;
+  };
+  auto c = classifier{i};
+  while (c.size() < 400) {
+    c.add_rule(random_rule());
+  }
+  EXPECT_TRUE(c.is_indexed());
+  // Mutates the rule base after it is indexed:
+  for (auto k = 0u; k < 200; ++k) {
+    c.pop_random_rule(rng);
+    c.rmv_rule(random_rule());
+    c.add_rule(random_rule());
+    auto const r = c.get_random_rule(rng);
+    c.add_rule(r.first, (r.second + 1) % 3);
+  }
+  EXPECT_TRUE(c.is_indexed());
+  EXPECT_EQ(c.size(), classifier(i, c.rules()).size());
+
+  auto dm = cj::data_matrix<double, uint32_t>{{"x0", "x1", "x2", "x3", "x4", "x5"}, "class"};
+  for (auto r = 0u; r < 500; ++r) {
+    auto row = cj::vector<double>{};
+    for (auto n = 0u; n < 6; ++n) {
+      row.push_back(unif(rng));
+    }
+    dm.add_row({row, uint32_t(unif(rng) * 3)});
+  }
+
+  auto expected = cj::confusion<size_t, double>{3};
+  for (auto const& row : dm) {
+    auto by_classes = cj::vector<Truth>(3, Truth{0});
+    for (auto const& rule : c.rules()) {
+      auto truth = Truth{1};
+      for (auto const& v : rule.first) {
+        truth = truth && i->get(v.first, v.second)(row.first[v.first]);
+      }
+      by_classes[rule.second] = by_classes[rule.second] || truth;
+    }
+    auto const prediction = cj::idx_of_maximum(by_classes);
+    EXPECT_EQ(prediction, c.evaluate(row.first));
+    expected.add_count(prediction, row.second);
+  }
+  auto const from_rows = c.evaluate_all(dm);
+  auto const from_tensor = c.evaluate_all(c.fuzzify(dm));
+  for (auto p = 0u; p < 3; ++p) {
+    for (auto o = 0u; o < 3; ++o) {
+      EXPECT_EQ(expected(p, o), from_rows(p, o));
+      EXPECT_EQ(expected(p, o), from_tensor(p, o));
+    }
+  }
+  EXPECT_THROW(c.evaluate({0.5, 0.5}), std::out_of_range);
+}
+
+TEST(CJFuzzyClassifier, IndexedEvaluationMatchesExhaustiveEvaluation) {
+  indexed_evaluation_matches_exhaustive_evaluation<cj::lukasiewicz<double>>();
+  indexed_evaluation_matches_exhaustive_evaluation<cj::godel<double>>();
+  indexed_evaluation_matches_exhaustive_evaluation<cj::product<double>>();
+  indexed_evaluation_matches_exhaustive_evaluation<cj::lukasiewicz<float>>();
+  indexed_evaluation_matches_exhaustive_evaluation<cj::product<float>>();
+  indexed_evaluation_matches_exhaustive_evaluation<cj::lukasiewicz<cj::fixed16>>();
+  indexed_evaluation_matches_exhaustive_evaluation<cj::godel<cj::fixed16>>();
+  indexed_evaluation_matches_exhaustive_evaluation<cj::product<cj::fixed16>>();
+}
+
+TEST(CJFuzzyClassifier, IncrementalHashDependsOnlyOnRules) {
+  using prod = cj::product<double>;
+  using classifier = cj::fuzzy_classifier<prod, double>;
+
+  auto const i = classifier::make_interpretation({"Blah", "Bleh"});
+  auto r0 = typename classifier::rule_type{{{0, 2}, {2, 1}}, 0};
+  auto r1 = typename classifier::rule_type{{{1, 2}, {3, 0}}, 1};
+  auto r2 = typename classifier::rule_type{{{0, 1}}, 1};
+
+  auto c0 = classifier{i};
+  EXPECT_EQ(0, c0.hash());
+  c0.add_rule(r0);
+  c0.add_rule(r1);
+  c0.add_rule(r2);
+
+  auto c1 = classifier{i, {r2, r0}};
+  EXPECT_NE(c0.hash(), c1.hash());
+  c1.add_rule(r1);
+  EXPECT_EQ(c0.hash(), c1.hash());
+  EXPECT_EQ(std::hash<classifier>{}(c0), std::hash<classifier>{}(c1));
+
+  // Changing the output of a rule:
+  c1.add_rule(r2.first, 0);
+  EXPECT_NE(c0.hash(), c1.hash());
+  c1.add_rule(r2.first, 1);
+  EXPECT_EQ(c0.hash(), c1.hash());
+
+  // Removing rules, including ones that are not there:
+  c1.rmv_rule(r1);
+  c1.rmv_rule(r1);
+  EXPECT_EQ((classifier{i, {r0, r2}}.hash()), c1.hash());
+
+  auto rng = std::mt19937_64(42);
+  while (!c1.empty()) {
+    c1.pop_random_rule(rng);
+  }
+  EXPECT_EQ(0, c1.hash());
+}
+
+template<typename Truth>
+auto evolution_does_not_depend_on_number_of_threads() -> void {
+  using classifier = cj::fuzzy_classifier<Truth, double>;
+  using rule_type = typename classifier::rule_type;
+
+  auto i = classifier::make_interpretation({"No", "Yes"});
+  i->add_triangular_partition("x", 3, 0.0, 1.0);
+  i->add_triangular_partition("y", 3, 0.0, 1.0);
+
+  auto rng = std::mt19937_64(7);
+  auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+  auto dm = cj::data_matrix<double, uint32_t>{{"x", "y"}, "z"};
+  for (auto r = 0u; r < 200; ++r) {
+    auto const x = unif(rng), y = unif(rng);
+    dm.add_row({{x, y}, uint32_t(x + 0.5 * y > 0.7)});
+  }
+
+  auto const mutate = [](classifier& c, std::mt19937_64& rng) {
+    auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+    if (c.size() < 2 || unif(rng) < 0.5) {
+      auto rule = rule_type{};
+      auto const input = uint32_t(unif(rng) * 2);
+      rule.first[input] = uint32_t(unif(rng) * 3);
+      rule.second = uint32_t(unif(rng) * 2);
+      c.add_rule(rule);
+    } else {
+      c.pop_random_rule(rng);
+    }
+  };
+  auto const fitness = [](classifier const& c, typename classifier::membership_tensor_type const& mt) {
+    return c.evaluate_all(mt).accuracy() - 0.001 * c.complexity();
+  };
+  auto const never = [](double) { return false; };
+
+  auto const initial = classifier{i, {{{{0, 0}}, 0}}};
+  auto const mt = initial.fuzzify(dm);
+  auto const serial = classifier::evolve(initial, mutate, fitness, never, mt, 40, 8, 20, 42, 10, 0.2, 100, 1);
+  auto const parallel = classifier::evolve(initial, mutate, fitness, never, mt, 40, 8, 20, 42, 10, 0.2, 100, 4);
+  auto const uncached = classifier::evolve(initial, mutate, fitness, never, mt, 40, 8, 20, 42, 10, 0.2, 0, 3);
+  EXPECT_EQ(serial, parallel);
+  EXPECT_EQ(serial, uncached);
+  EXPECT_TRUE(parallel.is_compiled());
+}
+
+TEST(CJFuzzyClassifier, EvolutionDoesNotDependOnNumberOfThreads) {
+  evolution_does_not_depend_on_number_of_threads<cj::lukasiewicz<double>>();
+  evolution_does_not_depend_on_number_of_threads<cj::lukasiewicz<float>>();
+  evolution_does_not_depend_on_number_of_threads<cj::lukasiewicz<cj::fixed16>>();
+  evolution_does_not_depend_on_number_of_threads<cj::product<cj::fixed16>>();
+}
+
+TEST(CJFuzzyClassifier, IslandEvolutionIsDeterministic) {
+  using luka = cj::lukasiewicz<double>;
+  using classifier = cj::fuzzy_classifier<luka, double>;
+  using rule_type = typename classifier::rule_type;
+
+  auto i = classifier::make_interpretation({"No", "Yes"});
+  i->add_triangular_partition("x", 3, 0.0, 1.0);
+  i->add_triangular_partition("y", 3, 0.0, 1.0);
+
+  auto rng = std::mt19937_64(11);
+  auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+  auto dm = cj::data_matrix<double, uint32_t>{{"x", "y"}, "z"};
+  for (auto r = 0u; r < 200; ++r) {
+    auto const x = unif(rng), y = unif(rng);
+    dm.add_row({{x, y}, uint32_t(x * y > 0.3)});
+  }
+
+  auto const mutate = [](classifier& c, std::mt19937_64& rng) {
+    auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+    if (c.size() < 2 || unif(rng) < 0.5) {
+      auto rule = rule_type{};
+      auto const input = uint32_t(unif(rng) * 2);
+      rule.first[input] = uint32_t(unif(rng) * 3);
+      rule.second = uint32_t(unif(rng) * 2);
+      c.add_rule(rule);
+    } else {
+      c.pop_random_rule(rng);
+    }
+  };
+  auto const fitness = [](classifier const& c, typename classifier::membership_tensor_type const& mt) {
+    return c.evaluate_all(mt).accuracy() - 0.001 * c.complexity();
+  };
+  auto const never = [](double) { return false; };
+
+  auto const initial = classifier{i, {{{{0, 0}}, 0}}};
+  auto const mt = initial.fuzzify(dm);
+  auto const ring1 = classifier::evolve_islands(initial, mutate, fitness, never, mt, 3, 5, 2,
+                                                cj::migration_topology::ring, 30, 6, 20);
+  auto const ring2 = classifier::evolve_islands(initial, mutate, fitness, never, mt, 3, 5, 2,
+                                                cj::migration_topology::ring, 30, 6, 20);
+  auto const full = classifier::evolve_islands(initial, mutate, fitness, never, mt, 3, 5, 2,
+                                               cj::migration_topology::fully_connected, 30, 6, 20);
+  EXPECT_EQ(ring1, ring2);
+  EXPECT_TRUE(full.is_compiled());
+  EXPECT_GE(fitness(ring1, mt), fitness(initial, mt));
+  EXPECT_GE(fitness(full, mt), fitness(initial, mt));
+
+  // A single island evolves like a single population:
+  auto const single = classifier::evolve_islands(initial, mutate, fitness, never, mt, 1, 5, 2,
+                                                 cj::migration_topology::ring, 30, 6, 20, 42);
+  auto const plain = classifier::evolve(initial, mutate, fitness, never, mt, 30, 6, 20,
+                                        cj::derive_seed(42, 1, 0), 100, 0.02, 10000, 1);
+  EXPECT_EQ(single, plain);
+}
+
+TEST(CJFuzzyClassifier, EvaluatesChunkSource) {
+  using luka = cj::lukasiewicz<double>;
+  using classifier = cj::fuzzy_classifier<luka, double>;
+
+  auto const dm = cj::data_matrix<double, uint32_t>::from_file("../data/poll_plant/poll.csv");
+  auto reader = cj::csv_chunk_reader<double, uint32_t>::open("../data/poll_plant/poll.csv", 128);
+  ASSERT_TRUE(dm && reader);
+
+  auto i = classifier::make_interpretation({"No", "Yes"});
+  for (auto const& name : dm->input_names()) {
+    i->add_triangular_partition(name, 3, 0.0, 1.0);
+  }
+  auto c = classifier{i, {{{{0, 2}, {3, 1}}, 1}, {{{5, 0}}, 0}, {{{1, 2}}, 1}}};
+  c.compile();
+
+  // Like a fitness function scoring the classifier on a dataset read by chunks:
+  auto const fitness = [](classifier const& c, cj::csv_chunk_reader<double, uint32_t>& source) {
+    return c.evaluate_all(source).tss(1);
+  };
+  auto const expected = c.evaluate_all(*dm);
+  for (auto pass = 0; pass < 2; ++pass) {
+    auto const con = c.evaluate_all(*reader);
+    EXPECT_EQ(dm->nrows(), con.count());
+    for (auto p = size_t{0}; p < 2; ++p) {
+      for (auto o = size_t{0}; o < 2; ++o) {
+        EXPECT_EQ(expected(p, o), con(p, o));
+      }
+    }
+  }
+  EXPECT_DOUBLE_EQ(expected.tss(1), fitness(c, *reader));
+}
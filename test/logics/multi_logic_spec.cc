@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "cj/logics/multi_logic.hh"
+
+template<typename Truth>
+auto single_logic_results(typename cj::fuzzy_classifier<cj::lukasiewicz<double>, double>::rules_type const& rules,
+                          cj::data_matrix<double, uint32_t> const& dm)
+    -> cj::pair<cj::confusion<size_t, double>, cj::vector<uint32_t>> {
+  using classifier = cj::fuzzy_classifier<Truth, double>;
+  auto i = classifier::make_interpretation({"A", "B", "C"});
+  i->add_triangular_partition("x", 3, 0.0, 1.0);
+  i->add_triangular_partition("y", 5, 0.0, 1.0);
+  i->add_triangular_partition("z", 4, 0.0, 1.0);
+  auto c = classifier{i};
+  for (auto const& r : rules) {
+    c.add_rule(r.first, r.second);
+  }
+  auto predictions = cj::vector<uint32_t>{};
+  for (auto const& row : dm) {
+    predictions.push_back(c.evaluate(row.first));
+  }
+  return {c.evaluate_all(c.fuzzify(dm)), predictions};
+}
+
+TEST(CJMultiLogic, MatchesSingleLogicEvaluations) {
+  using luka = cj::lukasiewicz<double>;
+  using classifier = cj::fuzzy_classifier<luka, double>;
+
+  auto i = classifier::make_interpretation({"A", "B", "C"});
+  i->add_triangular_partition("x", 3, 0.0, 1.0);
+  i->add_triangular_partition("y", 5, 0.0, 1.0);
+  i->add_triangular_partition("z", 4, 0.0, 1.0);
+
+  auto rng = std::mt19937_64(5);
+  auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+  auto c = classifier{i};
+  for (auto r = 0u; r < 30; ++r) {
+    auto rule = typename classifier::rule_type{};
+    for (auto n = 0u; n < 3; ++n) {
+      if (unif(rng) < 0.6) {
+        rule.first[n] = uint32_t(unif(rng) * i->num_partitions(n));
+      }
+    }
+    rule.second = uint32_t(unif(rng) * 3);
+    c.add_rule(rule);
+  }
+
+  auto dm = cj::data_matrix<double, uint32_t>{{"x", "y", "z"}, "class"};
+  for (auto r = 0u; r < 700; ++r) {
+    dm.add_row({{unif(rng), unif(rng), unif(rng)}, uint32_t(unif(rng) * 3)});
+  }
+
+  auto predictions = cj::vector<std::array<uint32_t, cj::num_fuzzy_logics>>{};
+  auto const all = cj::evaluate_all_logics(c, c.fuzzify(dm), &predictions);
+  auto const singles = std::array<cj::pair<cj::confusion<size_t, double>, cj::vector<uint32_t>>, 3>{
+    single_logic_results<cj::lukasiewicz<double>>(c.rules(), dm),
+    single_logic_results<cj::godel<double>>(c.rules(), dm),
+    single_logic_results<cj::product<double>>(c.rules(), dm)
+  };
+  ASSERT_EQ(dm.nrows(), predictions.size());
+  for (auto l = 0u; l < cj::num_fuzzy_logics; ++l) {
+    EXPECT_EQ(700, all[l].count());
+    for (auto p = 0u; p < 3; ++p) {
+      for (auto o = 0u; o < 3; ++o) {
+        EXPECT_EQ(singles[l].first(p, o), all[l](p, o));
+      }
+    }
+    for (auto r = 0u; r < dm.nrows(); ++r) {
+      EXPECT_EQ(singles[l].second[r], predictions[r][l]);
+    }
+  }
+  // The logics do not all agree on these rules:
+  EXPECT_NE(all[0].tss(1), all[2].tss(1));
+}
+
+TEST(CJMultiLogic, NamesLogics) {
+  EXPECT_EQ(cj::fuzzy_logic::godel, cj::fuzzy_logic_of<cj::godel<float>>::value);
+  EXPECT_EQ(cj::fuzzy_logic::product, cj::fuzzy_logic_of<cj::product<double>>::value);
+  EXPECT_EQ("Łukasiewicz", cj::fuzzy_logic_name(cj::fuzzy_logic::lukasiewicz));
+  EXPECT_EQ("Gödel-Dummett", cj::fuzzy_logic_name(cj::fuzzy_logic::godel));
+}
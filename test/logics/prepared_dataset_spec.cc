@@ -0,0 +1,117 @@
+#include "gtest/gtest.h"
+#include "cj/logics/fuzzy_classifier.hh"
+#include "cj/logics/prepared_dataset.hh"
+#include "cj/utils/parallel.hh"
+
+using luka = cj::lukasiewicz<double>;
+using classifier = cj::fuzzy_classifier<luka, double>;
+using prepared = cj::prepared_dataset<classifier>;
+
+static auto make_data(size_t nrows, size_t seed) -> cj::data_matrix<double, uint32_t> {
+  auto rng = std::mt19937_64(seed);
+  auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+  auto dm = cj::data_matrix<double, uint32_t>{{"x", "y"}, "z"};
+  for (auto r = 0u; r < nrows; ++r) {
+    auto const x = unif(rng), y = unif(rng);
+    dm.add_row({{x, y}, uint32_t(x + 0.5 * y > 0.7)});
+  }
+  return dm;
+}
+
+static auto make_interpretation() -> classifier::interpretation_ptr {
+  auto i = classifier::make_interpretation({"No", "Yes"});
+  i->add_triangular_partition("x", 3, 0.0, 1.0);
+  i->add_triangular_partition("y", 3, 0.0, 1.0);
+  return i;
+}
+
+TEST(CJPreparedDataset, FuzzifiesData) {
+  auto const dm = make_data(100, 3);
+  auto const i = make_interpretation();
+  auto const p = prepared::make(dm, i);
+
+  EXPECT_EQ(100, p->nrows());
+  EXPECT_EQ(dm.nrows(), p->data().nrows());
+  EXPECT_EQ(i, p->interpretation());
+
+  auto const c = p->classifier({{{{0, 1}}, 1}, {{{1, 0}}, 0}});
+  EXPECT_EQ(i, c.get_interpretation_ptr());
+  auto const mt = c.fuzzify(dm);
+  ASSERT_EQ(mt.num_columns(), p->memberships().num_columns());
+  for (auto k = 0u; k < mt.num_columns(); ++k) {
+    for (auto r = 0u; r < mt.nrows(); ++r) {
+      EXPECT_EQ(mt.column(k)[r], p->memberships().column(k)[r]);
+    }
+  }
+  EXPECT_EQ(c.evaluate_all(dm).tss(1), c.evaluate_all(p->memberships()).tss(1));
+}
+
+TEST(CJPreparedDataset, SharedByConcurrentEvolutions) {
+  using rule_type = classifier::rule_type;
+
+  auto const mutate = [](classifier& c, std::mt19937_64& rng) {
+    auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+    if (c.size() < 2 || unif(rng) < 0.5) {
+      auto rule = rule_type{};
+      auto const input = uint32_t(unif(rng) * 2);
+      rule.first[input] = uint32_t(unif(rng) * 3);
+      rule.second = uint32_t(unif(rng) * 2);
+      c.add_rule(rule);
+    } else {
+      c.pop_random_rule(rng);
+    }
+  };
+  auto const fitness = [](classifier const& c, classifier::membership_tensor_type const& mt) {
+    return c.evaluate_all(mt).accuracy() - 0.001 * c.complexity();
+  };
+  auto const never = [](double) { return false; };
+  auto const evolve = [&](prepared::const_ptr const& p, size_t seed) {
+    return classifier::evolve(p->classifier({{{{0, 0}}, 0}}), mutate, fitness, never, p->memberships(),
+                              30, 6, 15, seed, 10, 0.2, 100, 1);
+  };
+
+  auto p = prepared::make(make_data(200, 7), make_interpretation());
+  auto const serial = evolve(p, 42);
+
+  auto results = cj::vector<std::future<classifier>>{};
+  {
+    auto pool = cj::task_pool{4};
+    for (auto t = 0u; t < 8; ++t) {
+      results.push_back(pool.submit([p, &evolve] { return evolve(p, 42); }));
+    }
+  }
+  for (auto& r : results) {
+    EXPECT_EQ(serial, r.get());
+  }
+}
+
+TEST(CJPreparedDataset, PreparesViews) {
+  auto const shared = std::make_shared<cj::data_matrix<double, uint32_t> const>(make_data(300, 5));
+  auto rng = std::mt19937_64(3);
+  auto const [rest, sample] = cj::data_matrix_view<double, uint32_t>{shared}.split(0.25, rng);
+  auto const i = make_interpretation();
+  auto const p = prepared::make(sample, i);
+  EXPECT_EQ(75, p->nrows());
+  EXPECT_EQ(shared.get(), &p->data().matrix());
+
+  // The view is fuzzified and evaluated like a copy of its rows:
+  auto copy = cj::data_matrix<double, uint32_t>{shared->input_names(), shared->output_name()};
+  for (auto const& row : sample) {
+    copy.add_row({row.first.to_vector(), row.second});
+  }
+  auto const c = p->classifier({{{{0, 1}}, 1}, {{{1, 2}}, 0}});
+  auto const mt = c.fuzzify(copy);
+  for (auto k = 0u; k < mt.num_columns(); ++k) {
+    for (auto r = 0u; r < mt.nrows(); ++r) {
+      EXPECT_EQ(mt.column(k)[r], p->memberships().column(k)[r]);
+    }
+  }
+  auto const expected = c.evaluate_all(copy);
+  for (auto const& con : {c.evaluate_all(sample), c.evaluate_all(p->memberships())}) {
+    for (auto q = 0u; q < 2; ++q) {
+      for (auto o = 0u; o < 2; ++o) {
+        EXPECT_EQ(expected(q, o), con(q, o));
+      }
+    }
+  }
+}
@@ -37,5 +37,20 @@ TEST(CJConfusion, Adding2Dim) {
   EXPECT_EQ(5, c.false_negatives(1));
 }
 
+TEST(CJConfusion, AddsConfusions) {
+  auto a = cj::confusion<size_t>(2);
+  a.add_count(0, 0, 3);
+  a.add_count(1, 0, 2);
+  auto b = cj::confusion<size_t>(2);
+  b.add_count(1, 0, 1);
+  b.add_count(1, 1, 4);
+  a += b;
+  EXPECT_EQ(10, a.count());
+  EXPECT_EQ(3, a(0, 0));
+  EXPECT_EQ(3, a(1, 0));
+  EXPECT_EQ(4, a(1, 1));
+  EXPECT_EQ(0, a(0, 1));
+}
+
 //TEST(CJConfusion, RemovingCounts) {
 //}
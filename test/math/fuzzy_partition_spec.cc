@@ -0,0 +1,112 @@
+#include "gtest/gtest.h"
+#include "cj/math/truth.hh"
+#include "cj/math/fuzzy_partition.hh"
+
+using luka = cj::lukasiewicz<double>;
+using fuzzy_set = cj::fuzzy_set<double, luka>;
+
+TEST(CJFuzzyPartition, EvaluatesClosedFormShapes) {
+  auto const trap = fuzzy_set::trapezoid(0.0, 1.0, 2.0, 4.0, luka{0.0}, luka{1.0});
+  EXPECT_EQ(cj::fuzzy_set_kind::trapezoid, trap.kind());
+  EXPECT_DOUBLE_EQ(0.0, trap(-1.0).value);
+  EXPECT_DOUBLE_EQ(0.5, trap(0.5).value);
+  EXPECT_DOUBLE_EQ(1.0, trap(1.5).value);
+  EXPECT_DOUBLE_EQ(0.25, trap(3.5).value);
+  EXPECT_DOUBLE_EQ(0.0, trap(4.0).value);
+
+  auto const gauss = fuzzy_set::gaussian(1.0, 2.0, luka{0.0}, luka{1.0});
+  EXPECT_DOUBLE_EQ(1.0, gauss(1.0).value);
+  EXPECT_DOUBLE_EQ(std::exp(-0.5), gauss(3.0).value);
+  EXPECT_DOUBLE_EQ(gauss(-3.0).value, gauss(5.0).value);
+
+  auto const crisp = fuzzy_set::interval(1.0, 2.0, luka{0.0}, luka{1.0});
+  EXPECT_DOUBLE_EQ(0.0, crisp(0.5).value);
+  EXPECT_DOUBLE_EQ(1.0, crisp(1.0).value);
+  EXPECT_DOUBLE_EQ(0.0, crisp(2.0).value);
+
+  auto const tri = cj::make_triangle(0.0, 1.0, 3.0, luka{0.0}, luka{1.0}, luka{0.0});
+  EXPECT_DOUBLE_EQ(0.5, tri(0.5).value);
+  EXPECT_DOUBLE_EQ(0.5, tri(2.0).value);
+  EXPECT_DOUBLE_EQ(0.0, tri(3.0).value);
+}
+
+TEST(CJFuzzyPartition, WrapsFunctions) {
+  auto const f = fuzzy_set{[](double x) { return luka{x / 10}; }};
+  EXPECT_EQ(cj::fuzzy_set_kind::function, f.kind());
+  EXPECT_DOUBLE_EQ(0.3, f(3.0).value);
+}
+
+TEST(CJFuzzyPartition, BatchEvaluationMatchesScalarEvaluation) {
+  auto xs = cj::vector<double>{};
+  for (auto x = -0.2; x < 1.2; x += 0.01) {
+    xs.push_back(x);
+  }
+  auto sets = cj::make_triangles(5, 0.0, 1.0, luka{0.0}, luka{1.0});
+  for (auto const& s : cj::make_trapezoids(4, 0.0, 1.0, 0.5, luka{0.0}, luka{1.0})) {
+    sets.push_back(s);
+  }
+  for (auto const& s : cj::make_gaussians(3, 0.0, 1.0, luka{0.0}, luka{1.0})) {
+    sets.push_back(s);
+  }
+  for (auto const& s : cj::make_intervals(3, 0.0, 1.0, luka{0.0}, luka{1.0})) {
+    sets.push_back(s);
+  }
+  sets.push_back(fuzzy_set{[](double x) { return luka{x < 0.5? 0.0 : 1.0}; }});
+  sets.push_back(fuzzy_set::tabulate(sets[1], 6, 0.0, 1.0));
+
+  auto out = cj::vector<luka>(xs.size(), luka{-1.0});
+  for (auto const& s : sets) {
+    s(xs.data(), xs.size(), out.data());
+    for (auto i = 0u; i < xs.size(); ++i) {
+      EXPECT_EQ(s(xs[i]).value, out[i].value);
+    }
+  }
+}
+
+TEST(CJFuzzyPartition, PartitionsCoverTheDomain) {
+  auto const trapezoids = cj::make_trapezoids(4, 0.0, 3.0, 0.5, luka{0.0}, luka{1.0});
+  auto const gaussians = cj::make_gaussians(4, 0.0, 3.0, luka{0.0}, luka{1.0});
+  auto const intervals = cj::make_intervals(4, 0.0, 4.0, luka{0.0}, luka{1.0});
+  ASSERT_EQ(4, trapezoids.size());
+  ASSERT_EQ(4, gaussians.size());
+  ASSERT_EQ(4, intervals.size());
+
+  // Trapezoids sum to 1, Gaussians cross at half height, intervals do not overlap:
+  for (auto x = -1.0; x < 5.0; x += 0.125) {
+    auto sum = 0.0, crisp = 0.0;
+    for (auto s = 0u; s < 4; ++s) {
+      sum += trapezoids[s](x).value;
+      crisp += intervals[s](x).value;
+    }
+    EXPECT_NEAR(1.0, sum, 1e-12);
+    EXPECT_DOUBLE_EQ(1.0, crisp);
+  }
+  EXPECT_NEAR(0.5, gaussians[1](1.5).value, 1e-12);
+  EXPECT_NEAR(0.5, gaussians[2](1.5).value, 1e-12);
+  EXPECT_DOUBLE_EQ(1.0, intervals[0](-10.0).value);
+  EXPECT_DOUBLE_EQ(1.0, intervals[3](10.0).value);
+}
+
+TEST(CJFuzzyPartition, LookupTablesAreWithinTheirErrorBound) {
+  for (auto const n : {2u, 5u, 9u}) {
+    auto const sets = cj::make_triangles(n, 0.0, 1.0, luka{0.0}, luka{1.0});
+    for (auto const k : {4u, 8u, 12u}) {
+      auto const bound = (n - 1) / double(size_t{1} << (k + 1));
+      for (auto const& s : sets) {
+        auto const t = fuzzy_set::tabulate(s, k, 0.0, 1.0);
+        EXPECT_EQ(cj::fuzzy_set_kind::table, t.kind());
+        auto error = 0.0;
+        for (auto x = 0.0; x <= 1.0; x += 1.0 / 4099) {
+          error = std::max(error, std::abs(t(x).value - s(x).value));
+        }
+        EXPECT_LE(error, bound + 1e-12);
+      }
+    }
+  }
+
+  // Inputs outside of the range use the closest cell:
+  auto const t = fuzzy_set::tabulate(fuzzy_set::slope(0.0, 1.0, luka{1.0}, luka{0.0}), 3, 0.0, 1.0);
+  EXPECT_DOUBLE_EQ(1.0 - 1.0 / 16, t(-5.0).value);
+  EXPECT_DOUBLE_EQ(1.0 / 16, t(5.0).value);
+  EXPECT_DOUBLE_EQ(1.0 - 1.0 / 16, t(std::nan("")).value);
+}
@@ -0,0 +1,113 @@
+#include <random>
+#include "gtest/gtest.h"
+#include "cj/math/truth_kernels.hh"
+
+template<typename Truth>
+auto random_truths(size_t n, std::mt19937_64& rng) -> cj::vector<Truth> {
+  auto unif = std::uniform_real_distribution<double>(0.0, 1.0);
+  auto ts = cj::vector<Truth>{};
+  for (auto i = size_t{0}; i < n; ++i) {
+    auto const u = unif(rng);
+    // Some exact zeros and units, which saturate the operators:
+    ts.push_back(Truth{typename Truth::value_type(u < 0.1? 0.0 : (u > 0.9? 1.0 : unif(rng)))});
+  }
+  return ts;
+}
+
+template<typename Truth>
+auto expect_same(cj::vector<Truth> const& expected, cj::vector<Truth> const& actual) -> void {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (auto i = size_t{0}; i < expected.size(); ++i) {
+    EXPECT_TRUE(expected[i] == actual[i]) << i;
+  }
+}
+
+template<typename Truth>
+auto kernels_match_scalar_operators() -> void {
+  auto rng = std::mt19937_64(17);
+  for (auto const n : {size_t{0}, size_t{1}, size_t{3}, size_t{8}, size_t{17}, size_t{256}}) {
+    auto const a = random_truths<Truth>(n, rng);
+    auto const b = random_truths<Truth>(n, rng);
+    auto const c = random_truths<Truth>(n, rng);
+    auto expected = cj::vector<Truth>(n, Truth{0}), actual = expected;
+
+    cj::scalar::conjoin(a.data(), b.data(), expected.data(), n);
+    cj::conjoin(a.data(), b.data(), actual.data(), n);
+    expect_same(expected, actual);
+    for (auto i = size_t{0}; i < n; ++i) {
+      EXPECT_TRUE((a[i] && b[i]) == expected[i]);
+    }
+
+    cj::scalar::disjoin(a.data(), b.data(), expected.data(), n);
+    cj::disjoin(a.data(), b.data(), actual.data(), n);
+    expect_same(expected, actual);
+    for (auto i = size_t{0}; i < n; ++i) {
+      EXPECT_TRUE((a[i] || b[i]) == expected[i]);
+    }
+
+    // In place:
+    actual = a;
+    cj::conjoin(actual.data(), b.data(), actual.data(), n);
+    cj::scalar::conjoin(a.data(), b.data(), expected.data(), n);
+    expect_same(expected, actual);
+
+    auto const xs = cj::vector<Truth const*>{a.data(), b.data(), c.data()};
+    for (auto k = size_t{0}; k <= xs.size(); ++k) {
+      cj::scalar::conjoin_all(xs.data(), k, expected.data(), n);
+      cj::conjoin_all(xs.data(), k, actual.data(), n);
+      expect_same(expected, actual);
+      cj::scalar::disjoin_all(xs.data(), k, expected.data(), n);
+      cj::disjoin_all(xs.data(), k, actual.data(), n);
+      expect_same(expected, actual);
+    }
+    for (auto i = size_t{0}; i < n; ++i) {
+      EXPECT_TRUE(((a[i] || b[i]) || c[i]) == expected[i]);
+    }
+
+    expected = c;
+    actual = c;
+    cj::scalar::conjoin_disjoin(expected.data(), a.data(), b.data(), n);
+    cj::conjoin_disjoin(actual.data(), a.data(), b.data(), n);
+    expect_same(expected, actual);
+    for (auto i = size_t{0}; i < n; ++i) {
+      EXPECT_TRUE((c[i] || (a[i] && b[i])) == expected[i]);
+    }
+  }
+}
+
+TEST(CJTruthKernels, MatchScalarOperators) {
+  kernels_match_scalar_operators<cj::lukasiewicz<double>>();
+  kernels_match_scalar_operators<cj::godel<double>>();
+  kernels_match_scalar_operators<cj::product<double>>();
+  kernels_match_scalar_operators<cj::lukasiewicz<float>>();
+  kernels_match_scalar_operators<cj::godel<float>>();
+  kernels_match_scalar_operators<cj::product<float>>();
+  kernels_match_scalar_operators<cj::lukasiewicz<cj::fixed16>>();
+  kernels_match_scalar_operators<cj::product<cj::fixed16>>();
+}
+
+TEST(CJTruthKernels, HandleSpecialValues) {
+  using luka = cj::lukasiewicz<double>;
+  using godel = cj::godel<double>;
+  auto const nan = std::nan("");
+  auto const a = cj::vector<luka>{luka{nan}, luka{-0.0}, luka{0.5}, luka{1.0}, luka{0.3}};
+  auto const b = cj::vector<luka>{luka{0.5}, luka{0.0}, luka{nan}, luka{1.0}, luka{0.7}};
+  auto expected = cj::vector<luka>(5, luka{0}), actual = expected;
+  cj::scalar::conjoin(a.data(), b.data(), expected.data(), 5);
+  cj::conjoin(a.data(), b.data(), actual.data(), 5);
+  for (auto i = 0u; i < 5; ++i) {
+    EXPECT_EQ(std::signbit(expected[i].value), std::signbit(actual[i].value));
+    EXPECT_EQ(std::isnan(expected[i].value), std::isnan(actual[i].value));
+    EXPECT_TRUE(std::isnan(expected[i].value) || expected[i] == actual[i]);
+  }
+
+  auto const g = cj::vector<godel>{godel{nan}, godel{-0.0}, godel{0.0}, godel{0.4}};
+  auto const h = cj::vector<godel>{godel{0.2}, godel{0.0}, godel{-0.0}, godel{nan}};
+  auto gexpected = cj::vector<godel>(4, godel{0}), gactual = gexpected;
+  cj::scalar::disjoin(g.data(), h.data(), gexpected.data(), 4);
+  cj::disjoin(g.data(), h.data(), gactual.data(), 4);
+  for (auto i = 0u; i < 4; ++i) {
+    EXPECT_EQ(std::signbit(gexpected[i].value), std::signbit(gactual[i].value));
+    EXPECT_EQ(std::isnan(gexpected[i].value), std::isnan(gactual[i].value));
+  }
+}
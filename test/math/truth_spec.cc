@@ -9,3 +9,79 @@ TEST(CJTruth, LukakasiewiczNegation) {
   EXPECT_DOUBLE_EQ(luka{0.0}.value, (!luka{1.0}).value);
   EXPECT_DOUBLE_EQ(luka{1.0}.value, (!luka{0.0}).value);
 }
+
+TEST(CJTruth, SinglePrecisionLogics) {
+  using luka_f = cj::lukasiewicz<float>;
+  using prod_f = cj::product<float>;
+  using godel_f = cj::godel<float>;
+  EXPECT_FLOAT_EQ(0.5f, (luka_f{0.75f} && luka_f{0.75f}).value);
+  EXPECT_FLOAT_EQ(0.0f, (luka_f{0.25f} && luka_f{0.5f}).value);
+  EXPECT_FLOAT_EQ(1.0f, (luka_f{0.75f} || luka_f{0.5f}).value);
+  EXPECT_FLOAT_EQ(0.125f, (prod_f{0.25f} && prod_f{0.5f}).value);
+  EXPECT_FLOAT_EQ(0.625f, (prod_f{0.25f} || prod_f{0.5f}).value);
+  EXPECT_FLOAT_EQ(0.25f, (godel_f{0.25f} && godel_f{0.5f}).value);
+  EXPECT_FLOAT_EQ(0.5f, (godel_f{0.25f} || godel_f{0.5f}).value);
+}
+
+TEST(CJTruth, FixedPointConversions) {
+  using cj::fixed16;
+  EXPECT_EQ(0, fixed16{0}.raw);
+  EXPECT_EQ(65535, fixed16{1}.raw);
+  EXPECT_EQ(32768, fixed16{0.5}.raw); // 32767.5 rounds up.
+  EXPECT_EQ(0, fixed16{-0.3}.raw);
+  EXPECT_EQ(65535, fixed16{7.0}.raw);
+  EXPECT_EQ(0, fixed16{std::nan("")}.raw);
+  EXPECT_DOUBLE_EQ(1.0, double(fixed16{1.0}));
+  EXPECT_NEAR(0.3, double(fixed16{0.3}), 1.0 / 131070);
+  EXPECT_TRUE(fixed16{0.2} < fixed16{0.3});
+  EXPECT_EQ(sizeof(uint16_t), sizeof(cj::lukasiewicz<fixed16>));
+}
+
+TEST(CJTruth, FixedPointLukasiewiczSaturates) {
+  using luka16 = cj::lukasiewicz<cj::fixed16>;
+  auto const f = [](uint32_t r) { return luka16{cj::fixed16::from_raw(r)}; };
+  EXPECT_EQ(0, (f(20000) && f(30000)).value.raw);
+  EXPECT_EQ(0, (f(30000) && f(35535)).value.raw);
+  EXPECT_EQ(1, (f(30000) && f(35536)).value.raw);
+  EXPECT_EQ(65535, (f(65535) && f(65535)).value.raw);
+  EXPECT_EQ(65535, (f(40000) || f(40000)).value.raw);
+  EXPECT_EQ(65534, (f(30000) || f(35534)).value.raw);
+  EXPECT_EQ(65535, (f(65535) || f(0)).value.raw);
+  EXPECT_EQ(35535, (!f(30000)).value.raw);
+  EXPECT_EQ(65535, implication(f(100), f(200)).value.raw);
+  EXPECT_EQ(65435, implication(f(200), f(100)).value.raw);
+  EXPECT_EQ(65435, equivalence(f(100), f(200)).value.raw);
+  EXPECT_EQ(65435, equivalence(f(200), f(100)).value.raw);
+  // Exact arithmetic: the conjunction is associative.
+  for (auto a = 0u; a <= 65535; a += 4099) {
+    for (auto b = 0u; b <= 65535; b += 5113) {
+      for (auto c = 0u; c <= 65535; c += 6151) {
+        EXPECT_EQ(((f(a) && f(b)) && f(c)).value.raw, (f(a) && (f(b) && f(c))).value.raw);
+        EXPECT_EQ(((f(a) || f(b)) || f(c)).value.raw, (f(a) || (f(b) || f(c))).value.raw);
+      }
+    }
+  }
+}
+
+TEST(CJTruth, FixedPointProductRounds) {
+  using prod16 = cj::product<cj::fixed16>;
+  auto const f = [](uint32_t r) { return prod16{cj::fixed16::from_raw(r)}; };
+  auto const one = cj::fixed16::unit;
+  for (auto a = 0u; a <= one; a += 257) {
+    for (auto b = 0u; b <= one; b += 331) {
+      auto const exact = double(a) * double(b) / one;
+      EXPECT_LE(std::abs(double((f(a) && f(b)).value.raw) - exact), 0.5);
+      EXPECT_LE(std::abs(double((f(a) || f(b)).value.raw) - (a + b - exact)), 0.5);
+      EXPECT_LE((f(a) || f(b)).value.raw, one);
+    }
+    EXPECT_EQ(a, (f(a) && f(one)).value.raw);
+    EXPECT_EQ(0, (f(a) && f(0)).value.raw);
+    EXPECT_EQ(one, (f(a) || f(one)).value.raw);
+    EXPECT_EQ(a, (f(a) || f(0)).value.raw);
+  }
+  EXPECT_EQ(32768, (f(65535) && f(32768)).value.raw);
+  EXPECT_EQ(16384, (f(32768) && f(32768)).value.raw); // 16384.25 rounds down.
+  EXPECT_EQ(32768, implication(f(65535), f(32768)).value.raw);
+  EXPECT_EQ(43690, implication(f(49152), f(32768)).value.raw); // 2 / 3.
+  EXPECT_EQ(one, implication(f(100), f(100)).value.raw);
+}
@@ -0,0 +1,52 @@
+#include "gtest/gtest.h"
+#include "cj/utils/lru_cache.hh"
+
+TEST(CJLruCache, CreatesLruCache) {
+  auto const c = cj::lru_cache<size_t, double>(42);
+  EXPECT_TRUE(c.empty());
+  EXPECT_EQ(0, c.size());
+  EXPECT_EQ(42, c.max_size());
+}
+
+TEST(CJLruCache, FindsInsertedElements) {
+  auto c = cj::lru_cache<size_t, double>(4);
+  c.insert(1, 0.1);
+  c.insert(2, 0.2);
+  EXPECT_EQ(2, c.size());
+  ASSERT_NE(nullptr, c.find(1));
+  EXPECT_DOUBLE_EQ(0.1, *c.find(1));
+  EXPECT_DOUBLE_EQ(0.2, *c.find(2));
+  EXPECT_EQ(nullptr, c.find(3));
+
+  c.insert(1, 0.5);
+  EXPECT_EQ(2, c.size());
+  EXPECT_DOUBLE_EQ(0.5, *c.find(1));
+}
+
+TEST(CJLruCache, EvictsLeastRecentlyUsed) {
+  auto c = cj::lru_cache<char, int>(3);
+  c.insert('a', 0);
+  c.insert('b', 1);
+  c.insert('c', 2);
+  EXPECT_EQ(3, c.size());
+
+  c.find('a'); // 'b' is now the least recently used.
+  c.insert('d', 3);
+  EXPECT_EQ(3, c.size());
+  EXPECT_EQ(nullptr, c.find('b'));
+  EXPECT_NE(nullptr, c.find('a'));
+  EXPECT_NE(nullptr, c.find('c'));
+  EXPECT_NE(nullptr, c.find('d'));
+  EXPECT_EQ('d', c.begin()->first);
+
+  c.clear();
+  EXPECT_TRUE(c.empty());
+  EXPECT_EQ(nullptr, c.find('a'));
+}
+
+TEST(CJLruCache, EmptyCacheDoesNotStore) {
+  auto c = cj::lru_cache<int, int>(0);
+  c.insert(1, 1);
+  EXPECT_TRUE(c.empty());
+  EXPECT_EQ(nullptr, c.find(1));
+}
@@ -0,0 +1,82 @@
+#include <atomic>
+#include <chrono>
+#include "gtest/gtest.h"
+#include "cj/utils/parallel.hh"
+
+TEST(CJParallel, ParallelForVisitsEachIndexOnce) {
+  for (auto threads : {0u, 1u, 3u, 8u, 100u}) {
+    auto visits = cj::vector<int>(37, 0);
+    cj::parallel_for(visits.size(), threads, [&](size_t i) { ++visits[i]; });
+    for (auto const v : visits) {
+      EXPECT_EQ(1, v);
+    }
+  }
+}
+
+TEST(CJParallel, ParallelForWithNoIterations) {
+  auto count = std::atomic<int>{0};
+  cj::parallel_for(0, 4, [&](size_t) { ++count; });
+  EXPECT_EQ(0, count);
+}
+
+TEST(CJParallel, ParallelForRethrows) {
+  EXPECT_THROW(cj::parallel_for(10, 4, [](size_t i) {
+    if (i == 7) {
+      throw std::runtime_error("7");
+    }
+  }), std::runtime_error);
+}
+
+TEST(CJParallel, TaskPoolRunsEveryTask) {
+  for (auto threads : {0u, 1u, 4u}) {
+    auto count = std::atomic<int>{0};
+    auto results = cj::vector<std::future<size_t>>{};
+    {
+      auto pool = cj::task_pool{threads};
+      EXPECT_EQ(std::max(threads, 1u), pool.size());
+      for (auto i = size_t{0}; i < 50; ++i) {
+        results.push_back(pool.submit([i, &count] { ++count; return i * i; }));
+      }
+      for (auto i = size_t{0}; i < results.size(); ++i) {
+        EXPECT_EQ(i * i, results[i].get());
+      }
+    }
+    EXPECT_EQ(50, count);
+  }
+}
+
+TEST(CJParallel, TaskPoolRunsQueuedTasksBeforeJoining) {
+  auto count = std::atomic<int>{0};
+  {
+    auto pool = cj::task_pool{3};
+    for (auto i = 0; i < 20; ++i) {
+      pool.submit([&count] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ++count;
+      });
+    }
+  }
+  EXPECT_EQ(20, count);
+}
+
+TEST(CJParallel, TaskPoolRunsTasksSubmittedByTasks) {
+  auto count = std::atomic<int>{0};
+  {
+    auto pool = cj::task_pool{2};
+    for (auto i = 0; i < 10; ++i) {
+      pool.submit([&pool, &count] {
+        for (auto j = 0; j < 10; ++j) {
+          pool.submit([&count] { ++count; });
+        }
+      });
+    }
+  }
+  EXPECT_EQ(100, count);
+}
+
+TEST(CJParallel, TaskPoolForwardsExceptions) {
+  auto pool = cj::task_pool{2};
+  auto f = pool.submit([]() -> int { throw std::runtime_error("task"); });
+  EXPECT_THROW(f.get(), std::runtime_error);
+  EXPECT_EQ(3, pool.submit([] { return 3; }).get());
+}